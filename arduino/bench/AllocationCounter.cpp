@@ -0,0 +1,64 @@
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+#include "AllocationCounter.h"
+
+/**
+ * @class AllocationCounter
+ * @file AllocationCounter.cpp
+ * @brief On glibc malloc, calloc and realloc of the process are replaced by functions that count the call and forward it to glibc, so that the allocations of ArduinoJson (malloc) and of the standard library (operator new, which calls malloc) are both counted. Elsewhere only operator new is replaced and the allocations of ArduinoJson are not counted.
+ */
+static std::atomic<size_t> allocations(0);
+
+size_t AllocationCounter::get()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+#if defined(__GLIBC__)
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *memory, size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *memory, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(memory, size);
+}
+
+#else
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void *memory = malloc(size != 0 ? size : 1);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t size) noexcept
+{
+    free(memory);
+}
+
+#endif
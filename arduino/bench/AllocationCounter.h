@@ -0,0 +1,19 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <benchmark/benchmark.h>
+#include <stddef.h>
+
+//counts the heap allocations of the whole process, so that a benchmark can report how many allocations one operation costs
+class AllocationCounter {
+    public:
+        static size_t get();
+};
+
+//reports the allocations since start as counter allocs/op, i.e. divided by the number of iterations
+inline void reportAllocations(benchmark::State &state, size_t start)
+{
+    state.counters["allocs/op"] = benchmark::Counter((double)(AllocationCounter::get() - start), benchmark::Counter::kAvgIterations);
+}
+
+#endif
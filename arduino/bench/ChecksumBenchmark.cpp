@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+#include <Arduino.h>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "BitwiseCrc8.h"
+#include "Checksum.h"
+#include "Config.h"
+
+static std::vector<uint8_t> makeData(size_t length)
+{
+    std::vector<uint8_t> data(length);
+    for (size_t i = 0; i < length; i++)
+    {
+        data[i] = i * 31 + 7;
+    }
+
+    return data;
+}
+
+//s/byte is the time per payload byte, e.g. 2.5n for 2.5 ns/byte
+static void reportBytes(benchmark::State &state, size_t length)
+{
+    state.SetBytesProcessed(state.iterations() * length);
+    state.counters["s/byte"] = benchmark::Counter((double)(state.iterations() * length), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+//lookup table of Checksum.cpp, one table access per byte
+static void BM_Crc8Table(benchmark::State &state)
+{
+    std::vector<uint8_t> data = makeData(state.range(0));
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Checksum::crc8(data.data(), data.size()));
+    }
+
+    reportAllocations(state, allocations);
+    reportBytes(state, data.size());
+}
+BENCHMARK(BM_Crc8Table)->Arg(16)->Arg(64)->Arg(DEVICE::BATCH_MAX_PAYLOAD_SIZE);
+
+//the previous calcCRC8(..., 0xa7, 0x00, 0x00, true, true): reflection and eight shifts per byte
+static void BM_Crc8Bitwise(benchmark::State &state)
+{
+    std::vector<uint8_t> data = makeData(state.range(0));
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(calcCRC8(data.data(), data.size(), 0xa7, 0x00, 0x00, true, true));
+    }
+
+    reportAllocations(state, allocations);
+    reportBytes(state, data.size());
+}
+BENCHMARK(BM_Crc8Bitwise)->Arg(16)->Arg(64)->Arg(DEVICE::BATCH_MAX_PAYLOAD_SIZE);
@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "IntegrityMiddleware.h"
+#include "OutputQueue.h"
+#include "Packet.h"
+#include "PacketPool.h"
+#include "PacketRelay.h"
+#include "RelayQueue.h"
+#include "Config.h"
+
+//the ACK and parity packets that the middleware queues through the PacketRelay land in the relay queue and are dropped after each iteration
+static OutputQueue *getOutput()
+{
+    return getRelayQueue();
+}
+
+static std::shared_ptr<Packet> makePacket(uint8_t method, const char *payload)
+{
+    std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+    packet->setMethod(method);
+    packet->setPayload(payload);
+
+    return packet;
+}
+
+//binary ACK as the client sends it, see NET::ACK_PAYLOAD_SIZE
+static std::shared_ptr<Packet> makeAcknowledgement(uint16_t nextSequence, uint32_t bitmap)
+{
+    uint8_t payload[NET::ACK_PAYLOAD_SIZE] = {
+        (uint8_t)(nextSequence >> 8), (uint8_t)(nextSequence >> 0),
+        (uint8_t)(bitmap >> 24), (uint8_t)(bitmap >> 16), (uint8_t)(bitmap >> 8), (uint8_t)(bitmap >> 0)
+    };
+    std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+    packet->setMethod(NET::HEADER::METHOD_ACKNOWLEDGEMENT);
+    packet->setPayload(payload, sizeof(payload));
+
+    return packet;
+}
+
+//sensor data (BEST_EFFORT) on its way out: sequence and node identity, no send window; the argument is the FEC group size
+static void BM_IntegrityOutgoingData(benchmark::State &state)
+{
+    OutputQueue *output = getOutput();
+    IntegrityMiddleware middleware;
+    middleware.enableAckPackets();
+    middleware.setForwardErrorCorrection(state.range(0));
+    std::shared_ptr<Packet> packet = makePacket(NET::HEADER::METHOD_DATA, "{\"identity\":\"ACC1\",\"x\":0.12,\"y\":-9.81,\"z\":0.5}");
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        if (middleware.canSend(packet))
+            benchmark::DoNotOptimize(middleware.processOutgoingData(packet).get());
+        output->clear();
+    }
+
+    reportAllocations(state, allocations);
+}
+BENCHMARK(BM_IntegrityOutgoingData)->Arg(0)->Arg(4);
+
+//a RELIABLE response that is kept in the send window and released again by the ACK of the client
+static void BM_IntegrityReliableRoundTrip(benchmark::State &state)
+{
+    OutputQueue *output = getOutput();
+    IntegrityMiddleware middleware;
+    middleware.enableAckPackets();
+    std::shared_ptr<Packet> packet = makePacket(NET::HEADER::METHOD_INFO, "{\"cmd_name\":\"BATTERY_READ\",\"percentage\":\"100\"}");
+    uint16_t sequence = 0;
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        middleware.canSend(packet);
+        middleware.processOutgoingData(packet);
+        sequence++;
+        benchmark::DoNotOptimize(middleware.processIncomingData(makeAcknowledgement(sequence, 0)).size());
+        output->clear();
+    }
+
+    reportAllocations(state, allocations);
+}
+BENCHMARK(BM_IntegrityReliableRoundTrip);
+
+//commands that arrive in order; every NET::ACK_EVERY packets an ACK is queued
+static void BM_IntegrityIncomingInOrder(benchmark::State &state)
+{
+    OutputQueue *output = getOutput();
+    IntegrityMiddleware middleware;
+    middleware.enableAckPackets();
+    std::shared_ptr<Packet> packet = makePacket(NET::HEADER::METHOD_COMMAND, "{\"cmd_name\":\"BATTERY_READ\"}");
+    uint16_t sequence = 0;
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        packet->setSequence(sequence++);
+        benchmark::DoNotOptimize(middleware.processIncomingData(packet).size());
+        output->clear();
+    }
+
+    reportAllocations(state, allocations);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IntegrityIncomingInOrder);
+
+//commands that arrive swapped in pairs: the first one waits in the reorder buffer and causes an immediate ACK with a bitmap
+static void BM_IntegrityIncomingReordered(benchmark::State &state)
+{
+    OutputQueue *output = getOutput();
+    IntegrityMiddleware middleware;
+    middleware.enableAckPackets();
+    std::shared_ptr<Packet> first = makePacket(NET::HEADER::METHOD_COMMAND, "{\"cmd_name\":\"BATTERY_READ\"}");
+    std::shared_ptr<Packet> second = makePacket(NET::HEADER::METHOD_COMMAND, "{\"cmd_name\":\"BATTERY_READ\"}");
+    uint16_t sequence = 0;
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        first->setSequence(sequence);
+        second->setSequence(sequence + 1);
+        sequence += 2;
+        benchmark::DoNotOptimize(middleware.processIncomingData(second).size());
+        benchmark::DoNotOptimize(middleware.processIncomingData(first).size());
+        output->clear();
+    }
+
+    reportAllocations(state, allocations);
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_IntegrityIncomingReordered);
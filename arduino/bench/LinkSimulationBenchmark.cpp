@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include <Arduino.h>
+
+#include "LinkSimulation.h"
+#include "LossyLink.h"
+#include "Config.h"
+
+/**
+ * @brief runs the IntegrityMiddleware back to back over a LossyLink with the loss rate in percent of the first argument and the seed of the second; the other impairments are NET::LOSSY_LINK_*. the time is the cost of the simulation on the host, the counters describe the simulated link and are the same for every run with the same arguments:
+ * goodput in payload bytes per simulated second, retransmit_ratio as retransmissions per sent packet, delivered as share of the packets that arrived, reorder_depth as most packets in the reorder buffer, pool_high_water as most packet slots in use, heap_packets as packets and payloads that did not fit into the pool and link_queue as most packets delayed by the link.
+ */
+static void BM_LinkSimulation(benchmark::State &state)
+{
+    const size_t packetCount = 500;
+    const size_t payloadLength = 64;
+
+    LossyLinkImpairments impairments;
+    impairments.loss = state.range(0) / 100.0f;
+    LinkSimulationResult result = {};
+
+    for (auto _ : state)
+    {
+        LinkSimulation simulation(state.range(1), impairments);
+        result = simulation.run(packetCount, payloadLength, 600000);
+    }
+
+    state.counters["goodput"] = result.getGoodput();
+    state.counters["retransmit_ratio"] = result.getRetransmitRatio();
+    state.counters["delivered"] = (double)result.deliveredPackets / packetCount;
+    state.counters["reorder_depth"] = result.reorderBufferHighWater;
+    state.counters["pool_high_water"] = result.packetsHighWater;
+    state.counters["heap_packets"] = result.heapPackets;
+    state.counters["link_queue"] = result.link.queuedHighWater;
+}
+BENCHMARK(BM_LinkSimulation)
+    ->ArgNames({"loss%", "seed"})
+    ->Args({0, NET::LOSSY_LINK_SEED})
+    ->Args({1, NET::LOSSY_LINK_SEED})
+    ->Args({5, NET::LOSSY_LINK_SEED})
+    ->Args({10, NET::LOSSY_LINK_SEED})
+    ->Args({20, NET::LOSSY_LINK_SEED})
+    ->Args({30, NET::LOSSY_LINK_SEED})
+    ->Unit(benchmark::kMillisecond);
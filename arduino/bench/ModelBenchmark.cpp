@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+#include <Arduino.h>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "AccelerometerModel.h"
+#include "AHRSModel.h"
+
+template <typename Model>
+static Model makeModel();
+
+template <>
+AccelerometerModel makeModel<AccelerometerModel>()
+{
+    AccelerometerModel model;
+    model.x = 0.12f;
+    model.y = -9.81f;
+    model.z = 0.5f;
+    model.timestamp = 123456;
+    model.sequence = 789;
+
+    return model;
+}
+
+template <>
+AHRSModel makeModel<AHRSModel>()
+{
+    AHRSModel model;
+    model.pitch = 12.5f;
+    model.roll = -3.25f;
+    model.yaw = 179.75f;
+    model.timestamp = 123456;
+    model.sequence = 789;
+
+    return model;
+}
+
+//json payload of one sample with timestamp and sequence, as a sensor without binary encoding sends it
+template <typename Model>
+static void BM_ModelToJSON(benchmark::State &state)
+{
+    Model model = makeModel<Model>();
+    String identity = "ACC1";
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        std::vector<uint8_t> payload = model.toJSON(identity, true, true);
+        benchmark::DoNotOptimize(payload.data());
+    }
+
+    reportAllocations(state, allocations);
+}
+BENCHMARK_TEMPLATE(BM_ModelToJSON, AccelerometerModel);
+BENCHMARK_TEMPLATE(BM_ModelToJSON, AHRSModel);
+
+//binary payload of the same sample for comparison
+template <typename Model>
+static void BM_ModelToBinary(benchmark::State &state)
+{
+    Model model = makeModel<Model>();
+    String identity = "ACC1";
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        std::vector<uint8_t> payload = model.toBinary(identity, true, true);
+        benchmark::DoNotOptimize(payload.data());
+    }
+
+    reportAllocations(state, allocations);
+}
+BENCHMARK_TEMPLATE(BM_ModelToBinary, AccelerometerModel);
+BENCHMARK_TEMPLATE(BM_ModelToBinary, AHRSModel);
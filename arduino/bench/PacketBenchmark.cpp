@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "Packet.h"
+#include "PacketPool.h"
+#include "PacketParser.h"
+#include "Config.h"
+
+//payload of a packet with the given number of bytes; the bytes are not \0 so that the json and the binary path see the same payload
+static std::vector<uint8_t> makePayload(size_t length)
+{
+    std::vector<uint8_t> payload(length);
+    for (size_t i = 0; i < length; i++)
+    {
+        payload[i] = 'a' + i % 26;
+    }
+
+    return payload;
+}
+
+static std::shared_ptr<Packet> makePacket(size_t length)
+{
+    std::vector<uint8_t> payload = makePayload(length);
+    std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+    packet->setMethod(NET::HEADER::METHOD_DATA);
+    packet->setNodeIdentity(MC_NAME);
+    packet->setSequence(42);
+    packet->setPayload(payload.data(), payload.size());
+
+    return packet;
+}
+
+//building an outgoing packet: a packet from the pool, the payload copied into a payload slot and the checksum over it
+static void BM_PacketBuild(benchmark::State &state)
+{
+    std::vector<uint8_t> payload = makePayload(state.range(0));
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+        packet->setMethod(NET::HEADER::METHOD_DATA);
+        packet->setNodeIdentity(MC_NAME);
+        packet->setSequence(42);
+        packet->setPayload(payload.data(), payload.size());
+        benchmark::DoNotOptimize(packet.get());
+    }
+
+    reportAllocations(state, allocations);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PacketBuild)->Arg(16)->Arg(64)->Arg(DEVICE::BATCH_MAX_PAYLOAD_SIZE);
+
+static void BM_PacketSerialize(benchmark::State &state)
+{
+    std::shared_ptr<Packet> packet = makePacket(state.range(0));
+    uint8_t buffer[NET::MAX_BUFFER_SIZE];
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(packet->serialize(buffer, sizeof(buffer)));
+        benchmark::ClobberMemory();
+    }
+
+    reportAllocations(state, allocations);
+    state.SetBytesProcessed(state.iterations() * packet->getSerializedSize());
+}
+BENCHMARK(BM_PacketSerialize)->Arg(16)->Arg(64)->Arg(DEVICE::BATCH_MAX_PAYLOAD_SIZE);
+
+//decoding a received packet that is already in one buffer: header, payload and checksum
+static void BM_PacketDeserialize(benchmark::State &state)
+{
+    std::shared_ptr<Packet> source = makePacket(state.range(0));
+    uint8_t buffer[NET::MAX_BUFFER_SIZE];
+    size_t size = source->serialize(buffer, sizeof(buffer));
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+        packet->deserializeHeader(buffer);
+        packet->deserializePayload(buffer + Packet::getHeaderSize(), size - Packet::getHeaderSize());
+        benchmark::DoNotOptimize(packet->verifyGoodPacket());
+    }
+
+    reportAllocations(state, allocations);
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_PacketDeserialize)->Arg(16)->Arg(64)->Arg(DEVICE::BATCH_MAX_PAYLOAD_SIZE);
+
+//decoding a stream of back to back packets like the serial and BLE protocols receive it, fed in chunks of 64 bytes
+static void BM_PacketParser(benchmark::State &state)
+{
+    const size_t packetCount = 16;
+    const size_t chunkSize = 64;
+
+    std::vector<uint8_t> stream;
+    for (size_t i = 0; i < packetCount; i++)
+    {
+        std::shared_ptr<Packet> packet = makePacket(state.range(0));
+        size_t offset = stream.size();
+        stream.resize(offset + packet->getSerializedSize());
+        packet->serialize(stream.data() + offset, packet->getSerializedSize());
+    }
+
+    PacketParser parser;
+    size_t allocations = AllocationCounter::get();
+
+    for (auto _ : state)
+    {
+        for (size_t offset = 0; offset < stream.size(); offset += chunkSize)
+        {
+            parser.feed(stream.data() + offset, min(chunkSize, stream.size() - offset));
+        }
+
+        std::shared_ptr<Packet> packet;
+        while ((packet = parser.next()) != nullptr)
+        {
+            benchmark::DoNotOptimize(packet.get());
+        }
+    }
+
+    reportAllocations(state, allocations);
+    state.SetItemsProcessed(state.iterations() * packetCount);
+    state.SetBytesProcessed(state.iterations() * stream.size());
+}
+BENCHMARK(BM_PacketParser)->Arg(16)->Arg(64)->Arg(DEVICE::BATCH_MAX_PAYLOAD_SIZE);
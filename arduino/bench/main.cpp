@@ -0,0 +1,4 @@
+#include <benchmark/benchmark.h>
+
+//host benchmarks of the hot paths in lib/; run with pio run -e bench -t exec, see platformio.ini
+BENCHMARK_MAIN();
@@ -1,5 +1,6 @@
 #include <Arduino.h>
 #include <vector>
+#include <memory>
 
 #include "CommandManager.h"
 #include "NetworkCommands.h"
@@ -8,9 +9,11 @@
 #include "Logger.h"
 #include "NetworkManager.h"
 #include "DeviceManager.h"
+#include "Packet.h"
+#include "JsonArena.h"
 #include "Definitions.h"
 
-CommandManager::CommandManager(DeviceManager &deviceManager, NetworkManager &networkManager):deviceManager(deviceManager), networkManager(networkManager) {
+CommandManager::CommandManager(DeviceManager &deviceManager, NetworkManager &networkManager):deviceManager(deviceManager), networkManager(networkManager), arena(MC::COMMAND_ARENA_SIZE), command(&arena) {
     
     this->logger = Logger::getInstance();
     /**
@@ -28,6 +31,8 @@ CommandManager::CommandManager(DeviceManager &deviceManager, NetworkManager &net
     this->addCommand(CMD::CONNECTION_READ, new ConnectionRead(this->networkManager));
     this->addCommand(CMD::ACKNOWLEDGEMENT_ENABLE, new AcknowledgmentEnable(this->networkManager));
     this->addCommand(CMD::ACKNOWLEDGEMENT_DISABLE, new AcknowledgmentDisable(this->networkManager));
+    this->addCommand(CMD::SERIAL_FRAMING_SELECT, new SerialFramingSelect(this->networkManager));
+    this->addCommand(CMD::SEQUENCE_MODE_SELECT, new SequenceModeSelect(this->networkManager));
     
     #if WIRELESS_MODE == BLE
     #elif WIRELESS_MODE == WIFI
@@ -55,14 +60,39 @@ void CommandManager::addCommand(String identifier, ActuatorBase *actuator) {
     this->actuators[identifier] = actuator;
 }
 
+/**
+ * @brief parses the payload of a command packet into the reused command document and executes it. the previous command is cleared and its memory in the arena is released first, so a command is parsed without a heap allocation as long as it fits into MC::COMMAND_ARENA_SIZE.
+ */
+void CommandManager::executeCommand(std::shared_ptr<Packet> &packet) {
+    this->command.clear();
+    this->arena.reset();
+
+    // parse directly from the payload stored in the packet; no copy of the payload is made
+    unsigned long heapAllocations = this->arena.getHeapAllocations();
+    DeserializationError error = deserializeJson(this->command, packet->getPayloadView(), packet->getPayloadLength());
+
+    if (error) {
+        this->logger->ferror(prefix("can not deserialise json string: %%"), std::vector<String>{error.c_str()});
+        return;
+    }
+
+    if (this->arena.getHeapAllocations() > heapAllocations) {
+        this->logger->fdebug(prefix("command does not fit into the arena of %% bytes"), std::vector<String>{String(MC::COMMAND_ARENA_SIZE)});
+    }
+
+    this->executeCommand(&this->command);
+}
+
+/**
+ * @brief executes the command in the document. the document is not copied: the command name is removed from it before it is handed to a standard command, so that only the parameters are left.
+ */
 void CommandManager::executeCommand(JsonDocument *json) {
-    auto commandData = *json;
-    String commandName = commandData["cmd_name"].as<String>();
+    String commandName = (*json)["cmd_name"].as<String>();
     
     //here we check for standard commands
     if (this->commands.find(commandName) != this->commands.end()) {
-        commandData.remove("cmd_name"); //remove the command name so that only the parameters are left
-        this->commands[commandName]->execute(&commandData);
+        json->remove("cmd_name"); //remove the command name so that only the parameters are left
+        this->commands[commandName]->execute(json);
     }
     else if (this->actuators.find(commandName) != this->actuators.end()) {        
         this->actuators[commandName]->executeFunction(commandName, *json);        
@@ -70,4 +100,8 @@ void CommandManager::executeCommand(JsonDocument *json) {
     else {
         this->logger->ferror(prefix("command %% not found"), std::vector<String>{ commandName });
     }    
+}
+
+unsigned long CommandManager::getHeapAllocations() {
+    return this->arena.getHeapAllocations();
 }
\ No newline at end of file
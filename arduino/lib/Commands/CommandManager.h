@@ -4,12 +4,15 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <map>
+#include <memory>
 
 #include "CommandBase.h"
 #include "Logger.h"
 #include "NetworkManager.h"
 #include "DeviceManager.h"
 #include "ActuatorBase.h"
+#include "Packet.h"
+#include "JsonArena.h"
 #include "Definitions.h"
 
 class CommandManager {
@@ -18,7 +21,9 @@ class CommandManager {
         ~CommandManager();
         void addCommand(String identifier, CommandBase* cmd);
         void addCommand(String identifier, ActuatorBase *actuator);
+        void executeCommand(std::shared_ptr<Packet> &packet);
         void executeCommand(JsonDocument *json);
+        unsigned long getHeapAllocations();//blocks of parsed commands that did not fit into the arena
 
     private:
         std::map<String, CommandBase*> commands;
@@ -26,6 +31,8 @@ class CommandManager {
         DeviceManager &deviceManager;
         NetworkManager &networkManager;
         Logger *logger;
+        JsonArena arena;
+        JsonDocument command;//reused for every received command; its memory comes from the arena
 };
 
 #endif
\ No newline at end of file
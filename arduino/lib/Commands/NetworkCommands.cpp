@@ -60,3 +60,15 @@ AcknowledgmentDisable::AcknowledgmentDisable(NetworkManager &networkManager): ne
 void AcknowledgmentDisable::execute(JsonDocument *json) {
     this->networkManager.disableAckPackets();
 }
+
+SerialFramingSelect::SerialFramingSelect(NetworkManager &networkManager): networkManager(networkManager)  {}
+
+void SerialFramingSelect::execute(JsonDocument *json) {
+    this->networkManager.selectSerialFraming(json);
+}
+
+SequenceModeSelect::SequenceModeSelect(NetworkManager &networkManager): networkManager(networkManager)  {}
+
+void SequenceModeSelect::execute(JsonDocument *json) {
+    this->networkManager.selectSequenceMode(json);
+}
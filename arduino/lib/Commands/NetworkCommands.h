@@ -91,4 +91,22 @@ class AcknowledgmentDisable: public CommandBase {
         NetworkManager &networkManager;
 };
 
+class SerialFramingSelect: public CommandBase {
+    public:
+        SerialFramingSelect(NetworkManager &networkManager);
+        void execute(JsonDocument *json) override;
+
+    private:
+        NetworkManager &networkManager;
+};
+
+class SequenceModeSelect: public CommandBase {
+    public:
+        SequenceModeSelect(NetworkManager &networkManager);
+        void execute(JsonDocument *json) override;
+
+    private:
+        NetworkManager &networkManager;
+};
+
 #endif
\ No newline at end of file
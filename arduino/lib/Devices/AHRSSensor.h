@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <vector>
 
 #include "SensorBase.h"
 
@@ -10,7 +11,7 @@ class AHRSSensor : public SensorBase {
     public:
         AHRSSensor(const String& identity);
         
-        String readData() override;
+        std::vector<uint8_t> readData() override;
         void identificationAction() override;
         void getModelDefinition(JsonObject& json) override;
 };
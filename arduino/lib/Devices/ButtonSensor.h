@@ -4,6 +4,7 @@
 #include <M5Stack.h>
 #undef min
 #include <ArduinoJson.h>
+#include <vector>
 
 #include "SensorBase.h"
 
@@ -11,9 +12,10 @@ class ButtonSensor : public SensorBase {
     public:
         ButtonSensor(const String &identity, String buttonName);
 
-        String readData() override;
+        std::vector<uint8_t> readData() override;
         void identificationAction() override;
         void getModelDefinition(JsonObject& json) override;
+        NET::DeliveryClass getDeliveryClass() override;
 
     private:
         Button *button;
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <vector>
 #include <VL53L0X.h>
 
 #include "SensorBase.h"
@@ -11,7 +12,7 @@ class DistanceSensor : public SensorBase {
     public:
         DistanceSensor(const String &identity);
 
-        String readData() override;
+        std::vector<uint8_t> readData() override;
         void identificationAction() override;
         void getModelDefinition(JsonObject& json) override;
 
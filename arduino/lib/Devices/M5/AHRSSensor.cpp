@@ -7,13 +7,13 @@
 
 AHRSSensor::AHRSSensor(const String &identity): SensorBase(identity) {}
 
-String AHRSSensor::readData()
+std::vector<uint8_t> AHRSSensor::readData()
 {
     AHRSModel model = AHRSModel();
     M5.Imu.getAhrsData(&model.pitch, &model.roll, &model.yaw);
     
     this->appendMetaData(model);
-    return this->toJSON(model);
+    return this->toPayload(model);
 }
 
 void AHRSSensor::identificationAction() {
@@ -22,5 +22,5 @@ void AHRSSensor::identificationAction() {
 
 void AHRSSensor::getModelDefinition(JsonObject& json) {
     AHRSModel model = AHRSModel();
-    model.getModelDefinition(json);
+    this->appendModelDefinition(model, json);
 }
\ No newline at end of file
@@ -9,12 +9,12 @@
 
 AccelerometerSensor::AccelerometerSensor(const String &identity): SensorBase(identity) {}
 
-String AccelerometerSensor::readData() {
+std::vector<uint8_t> AccelerometerSensor::readData() {
     AccelerometerModel model = AccelerometerModel();
     M5.Imu.getAccelData(&model.x, &model.y, &model.z);
     this->appendMetaData(model);
     
-    String output = this->toJSON(model);
+    std::vector<uint8_t> output = this->toPayload(model);
     
     this->lastState = output;
 
@@ -27,5 +27,5 @@ void AccelerometerSensor::identificationAction() {
 
 void AccelerometerSensor::getModelDefinition(JsonObject& json) {
     AccelerometerModel model = AccelerometerModel();
-    model.getModelDefinition(json);
+    this->appendModelDefinition(model, json);
 }
\ No newline at end of file
@@ -20,13 +20,13 @@ ButtonSensor::ButtonSensor(const String &identity, String buttonName): SensorBas
     }
 }
 
-String ButtonSensor::readData() {
+std::vector<uint8_t> ButtonSensor::readData() {
     ButtonModel model;
     if (button == nullptr) this->logger->error(prefix("button is nullptr"));
     model.isPressed = button->isPressed();
     
     this->appendMetaData(model);
-    return this->toJSON(model);
+    return this->toPayload(model);
 }
 
 void ButtonSensor::identificationAction() {
@@ -35,5 +35,10 @@ void ButtonSensor::identificationAction() {
 
 void ButtonSensor::getModelDefinition(JsonObject& json) {
     ButtonModel model = ButtonModel();
-    model.getModelDefinition(json);
+    this->appendModelDefinition(model, json);
+}
+
+//a button is a state: a retransmission of an old press is superseded by the current state
+NET::DeliveryClass ButtonSensor::getDeliveryClass() {
+    return NET::DeliveryClass::LATEST_VALUE;
 }
\ No newline at end of file
@@ -13,12 +13,12 @@ DistanceSensor::DistanceSensor(const String &identity): SensorBase(identity) {
     this->sensor.startContinuous();
 }
 
-String DistanceSensor::readData() {
+std::vector<uint8_t> DistanceSensor::readData() {
     DistanceModel model = DistanceModel();
     int range = sensor.readRangeSingleMillimeters();
     model.range = range;
     this->appendMetaData(model);
-    return this->toJSON(model);
+    return this->toPayload(model);
 }
 
 void DistanceSensor::identificationAction() {
@@ -27,5 +27,5 @@ void DistanceSensor::identificationAction() {
 
 void DistanceSensor::getModelDefinition(JsonObject& json) {
     DistanceModel model = DistanceModel();
-    model.getModelDefinition(json);
+    this->appendModelDefinition(model, json);
 }
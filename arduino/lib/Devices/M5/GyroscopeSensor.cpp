@@ -6,13 +6,13 @@
 
 GyroscopeSensor::GyroscopeSensor(const String &identity): SensorBase(identity) {}
 
-String GyroscopeSensor::readData()
+std::vector<uint8_t> GyroscopeSensor::readData()
 {
     GyroscopeModel model = GyroscopeModel();
     M5.Imu.getGyroData(&model.x, &model.y, &model.z);
     
     this->appendMetaData(model);
-    return this->toJSON(model);
+    return this->toPayload(model);
 }
 
 void GyroscopeSensor::identificationAction() {
@@ -21,5 +21,5 @@ void GyroscopeSensor::identificationAction() {
 
 void GyroscopeSensor::getModelDefinition(JsonObject& json) {
     GyroscopeModel model = GyroscopeModel();
-    model.getModelDefinition(json);
+    this->appendModelDefinition(model, json);
 }
\ No newline at end of file
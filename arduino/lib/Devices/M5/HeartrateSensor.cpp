@@ -13,13 +13,13 @@ HeartrateSensor::HeartrateSensor(const String &identity): SensorBase(identity) {
     }
 }
 
-String HeartrateSensor::readData() {
+std::vector<uint8_t> HeartrateSensor::readData() {
     pox.update();
     HeartrateModel model = HeartrateModel();
     model.heartRate = pox.getHeartRate();
     model.sp02 = pox.getSpO2();
     this->appendMetaData(model);
-    return this->toJSON(model);
+    return this->toPayload(model);
 }
 
 void HeartrateSensor::identificationAction() {
@@ -28,5 +28,5 @@ void HeartrateSensor::identificationAction() {
 
 void HeartrateSensor::getModelDefinition(JsonObject& json) {
     HeartrateModel model = HeartrateModel();
-    model.getModelDefinition(json);
+    this->appendModelDefinition(model, json);
 }
\ No newline at end of file
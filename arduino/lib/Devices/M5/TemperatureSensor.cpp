@@ -7,13 +7,13 @@
 
 TemperatureSensor::TemperatureSensor(const String &identity): SensorBase(identity) {}
 
-String TemperatureSensor::readData()
+std::vector<uint8_t> TemperatureSensor::readData()
 {
     TemperatureModel model = TemperatureModel();
     M5.Imu.getTempData(&model.temperature);
     
     this->appendMetaData(model);
-    return this->toJSON(model);
+    return this->toPayload(model);
 }
 
 void TemperatureSensor::identificationAction() {
@@ -22,5 +22,5 @@ void TemperatureSensor::identificationAction() {
 
 void TemperatureSensor::getModelDefinition(JsonObject& json) {
     TemperatureModel model = TemperatureModel();
-    model.getModelDefinition(json);
+    this->appendModelDefinition(model, json);
 }
\ No newline at end of file
@@ -23,6 +23,15 @@ bool SensorBase::isTimeToRun() {
     return false;
 }
 
+/**
+ * @return milli seconds until isTimeToRun returns true; the main loop sleeps at most this long
+ */
+unsigned long SensorBase::getTimeToRun(unsigned long now) {
+    unsigned long elapsed = now - this->lastRun;
+
+    return elapsed >= this->interval ? 0 : this->interval - elapsed;
+}
+
 unsigned long SensorBase::getSequence() {
     return this->sequence;
 }
@@ -41,10 +50,25 @@ void SensorBase::appendMetaData(ModelBase &model) {
     }
 }
 
-String SensorBase::toJSON(ModelBase &model) {
+/**
+ * @brief encodes the model as payload for a data packet in the encoding that was selected for this sensor with RECORD_CREATE
+ */
+std::vector<uint8_t> SensorBase::toPayload(ModelBase &model) {
+    if (this->capabilities.binaryEncoding) {
+        return model.toBinary(this->identity, this->capabilities.includeTimestamp, this->capabilities.includeSequence);
+    }
+
     return model.toJSON(this->identity, this->capabilities.includeTimestamp, this->capabilities.includeSequence);
 }
 
+/**
+ * @brief adds the field definitions of the model and the layout of its binary encoding so that the client can decode binary payloads
+ */
+void SensorBase::appendModelDefinition(ModelBase &model, JsonObject &json) {
+    model.getModelDefinition(json);
+    json["binary_format"] = model.getBinaryFormat(this->capabilities.includeTimestamp, this->capabilities.includeSequence);
+}
+
 SensorCapabilities* SensorBase::getSensorCapabilties() {
     return &this->capabilities;
 }
@@ -55,6 +79,7 @@ void SensorBase::setSensorCapabilities(SensorCapabilities* capabilities) {
     this->capabilities.includeSequence = capabilities->includeSequence;
     this->capabilities.sampleRate = capabilities->sampleRate;
     this->capabilities.dataOnStateChange = capabilities->dataOnStateChange;
+    this->capabilities.binaryEncoding = capabilities->binaryEncoding;
     this->calculateInterval();
 }
 
@@ -64,16 +89,24 @@ void SensorBase::resetSensorCapabilities() {
     this->capabilities.includeSequence = SENS::DEFAULT_INCLUDE_SEQUENCE;
     this->capabilities.sampleRate = SENS::DEFAULT_SAMPLE_RATE;
     this->capabilities.dataOnStateChange = SENS::DEFAULT_DATA_ON_CHANGE;
+    this->capabilities.binaryEncoding = SENS::DEFAULT_BINARY_ENCODING;
     this->sequence = 0;
     this->calculateInterval();
 }
 
-bool SensorBase::hasStateChanged(String &currentState) {
+bool SensorBase::hasStateChanged(std::vector<uint8_t> &currentState) {
     if (!this->capabilities.dataOnStateChange) return true;
 
     return this->lastState != currentState;
 }
 
+/**
+ * @brief how the integrity layer treats the packets of this sensor when ACK packets are enabled. a sensor that only sends when its state changes describes a state, so only its latest value is worth a retransmission; samples of other sensors are worthless when they arrive late.
+ */
+NET::DeliveryClass SensorBase::getDeliveryClass() {
+    return this->capabilities.dataOnStateChange ? NET::DeliveryClass::LATEST_VALUE : NET::DeliveryClass::BEST_EFFORT;
+}
+
 void SensorBase::enable()
 {
     this->capabilities.enable = true;
@@ -3,10 +3,12 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <vector>
 
 #include "DeviceBase.h"
 #include "ModelBase.h"
 #include "Capabilities.h"
+#include "Config.h"
 
 class SensorBase: public DeviceBase, public ISensorCapabilities {
 
@@ -18,11 +20,13 @@ class SensorBase: public DeviceBase, public ISensorCapabilities {
         void setSensorCapabilities(SensorCapabilities* capabilities) override;
         void resetSensorCapabilities() override;
 
-        virtual String readData() = 0;
+        virtual std::vector<uint8_t> readData() = 0;
         virtual void getModelDefinition(JsonObject& json) = 0;
+        virtual NET::DeliveryClass getDeliveryClass();
 
-        bool hasStateChanged(String &currentState);
+        bool hasStateChanged(std::vector<uint8_t> &currentState);
         bool isTimeToRun();
+        unsigned long getTimeToRun(unsigned long now);
         unsigned long getSequence();
         void resetSequence();
 
@@ -32,13 +36,14 @@ class SensorBase: public DeviceBase, public ISensorCapabilities {
 
     protected:
         unsigned long interval;
-        String lastState;
+        std::vector<uint8_t> lastState;
         SensorCapabilities capabilities;
         unsigned long lastRun;
         unsigned long sequence;
         
         void appendMetaData(ModelBase &model);
-        String toJSON(ModelBase &model);
+        std::vector<uint8_t> toPayload(ModelBase &model);
+        void appendModelDefinition(ModelBase &model, JsonObject &json);
         void calculateInterval();
 };
 
@@ -14,4 +14,11 @@ void AHRSModel::appendModelData(JsonDocument &obj)
     obj["pitch"] = this->pitch;
     obj["roll"] = this->roll;
     obj["yaw"] = this->yaw;
+}
+
+void AHRSModel::appendModelBinary(BinaryWriter &writer)
+{
+    writer.writeFloat(this->pitch);
+    writer.writeFloat(this->roll);
+    writer.writeFloat(this->yaw);
 }
\ No newline at end of file
@@ -15,6 +15,7 @@ class AHRSModel: public ModelBase {
         
         void getModelDefinition(JsonObject& json) override;
         void appendModelData(JsonDocument& obj) override;
+        void appendModelBinary(BinaryWriter& writer) override;
 };
 
 #endif
\ No newline at end of file
@@ -13,4 +13,10 @@ void AccelerometerModel::appendModelData(JsonDocument &obj) {
     obj["x"] = this->x;
     obj["y"] = this->y;
     obj["z"] = this->z;
+}
+
+void AccelerometerModel::appendModelBinary(BinaryWriter &writer) {
+    writer.writeFloat(this->x);
+    writer.writeFloat(this->y);
+    writer.writeFloat(this->z);
 }
\ No newline at end of file
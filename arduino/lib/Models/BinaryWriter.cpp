@@ -0,0 +1,77 @@
+#include <Arduino.h>
+#include <vector>
+
+#include "BinaryWriter.h"
+
+/**
+ * @class BinaryWriter
+ * @file BinaryWriter.cpp
+ * @brief Encodes the fields of a model into the compact binary payload of data packets.
+ *
+ * All values are written in little endian because this is the native byte order of the ESP32 and the host can decode it with the python struct module. The format characters are the ones of the python struct module, so getFormat() can directly be used by the host for struct.unpack.
+ *
+ * @cite https://docs.python.org/3/library/struct.html#format-characters
+ */
+BinaryWriter::BinaryWriter(std::vector<uint8_t> *buffer) : buffer(buffer), format("<") {}
+
+void BinaryWriter::writeFloat(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    this->writeBytes(bits, sizeof(bits), 'f');
+}
+
+void BinaryWriter::writeInt(int32_t value)
+{
+    this->writeBytes((uint32_t)value, sizeof(value), 'i');
+}
+
+void BinaryWriter::writeUInt8(uint8_t value)
+{
+    this->writeBytes(value, sizeof(value), 'B');
+}
+
+void BinaryWriter::writeBool(bool value)
+{
+    this->writeBytes(value ? 1 : 0, 1, '?');
+}
+
+void BinaryWriter::writeUInt32(uint32_t value)
+{
+    this->writeBytes(value, sizeof(value), 'I');
+}
+
+/**
+ * @brief the identity of the sensor has a variable length, therefore it is prefixed with its length and not part of the format string.
+ */
+void BinaryWriter::writeIdentity(const String &identity)
+{
+    if (this->buffer == nullptr)
+        return;
+
+    uint8_t length = identity.length() > UINT8_MAX ? UINT8_MAX : identity.length();
+    this->buffer->push_back(length);
+    this->buffer->insert(this->buffer->end(), identity.c_str(), identity.c_str() + length);
+}
+
+/**
+ * @return layout of the written fields as python struct format string, e.g. "<fff" for three floats
+ */
+String BinaryWriter::getFormat()
+{
+    return this->format;
+}
+
+void BinaryWriter::writeBytes(uint32_t value, size_t length, char formatCharacter)
+{
+    if (this->buffer == nullptr)
+    {
+        this->format += formatCharacter;
+        return;
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        this->buffer->push_back(value >> (8 * i));
+    }
+}
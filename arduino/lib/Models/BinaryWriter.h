@@ -0,0 +1,28 @@
+#ifndef BINARY_WRITER_H
+#define BINARY_WRITER_H
+
+#include <Arduino.h>
+#include <vector>
+
+//writes model fields as fixed-layout little endian values; without a buffer it only records the layout as a python struct format string
+class BinaryWriter {
+    public:
+        BinaryWriter(std::vector<uint8_t> *buffer);
+
+        void writeFloat(float value);
+        void writeInt(int32_t value);
+        void writeUInt8(uint8_t value);
+        void writeBool(bool value);
+        void writeUInt32(uint32_t value);
+        void writeIdentity(const String &identity);
+
+        String getFormat();
+
+    private:
+        void writeBytes(uint32_t value, size_t length, char formatCharacter);
+
+        std::vector<uint8_t> *buffer;
+        String format;
+};
+
+#endif
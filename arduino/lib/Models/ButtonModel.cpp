@@ -11,3 +11,8 @@ void ButtonModel::appendModelData(JsonDocument &obj)
 {
     obj["is_pressed"] = this->isPressed;
 }
+
+void ButtonModel::appendModelBinary(BinaryWriter &writer)
+{
+    writer.writeBool(this->isPressed);
+}
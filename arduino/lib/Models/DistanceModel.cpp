@@ -10,3 +10,7 @@ void DistanceModel::getModelDefinition(JsonObject& json) {
 void DistanceModel::appendModelData(JsonDocument& obj) {
     obj["range"] = this->range;
 }
+
+void DistanceModel::appendModelBinary(BinaryWriter &writer) {
+    writer.writeInt(this->range);
+}
@@ -13,6 +13,7 @@ class DistanceModel: public ModelBase {
     
         void getModelDefinition(JsonObject& json) override;
         void appendModelData(JsonDocument& obj) override;
+        void appendModelBinary(BinaryWriter& writer) override;
 };
 
 #endif
\ No newline at end of file
@@ -14,4 +14,11 @@ void GyroscopeModel::appendModelData(JsonDocument &obj)
     obj["x"] = this->x;
     obj["y"] = this->y;
     obj["z"] = this->z;
+}
+
+void GyroscopeModel::appendModelBinary(BinaryWriter &writer)
+{
+    writer.writeFloat(this->x);
+    writer.writeFloat(this->y);
+    writer.writeFloat(this->z);
 }
\ No newline at end of file
@@ -15,6 +15,7 @@ class GyroscopeModel: public ModelBase {
     
         void getModelDefinition(JsonObject& json) override;
         void appendModelData(JsonDocument& obj) override;
+        void appendModelBinary(BinaryWriter& writer) override;
 };
 
 #endif
\ No newline at end of file
@@ -9,4 +9,9 @@ void HeartrateModel::getModelDefinition(JsonObject& json) {
 void HeartrateModel::appendModelData(JsonDocument& obj) {
     obj["heartrate"] = this->heartRate;
     obj["sp02"] = this->sp02;
+}
+
+void HeartrateModel::appendModelBinary(BinaryWriter &writer) {
+    writer.writeFloat(this->heartRate);
+    writer.writeUInt8(this->sp02);
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 #include <ArduinoJson.h>
+#include <vector>
 
 #include "ModelBase.h"
+#include "BinaryWriter.h"
 
-String ModelBase::toJSON(const String &identity, bool include_timestamp, bool include_sequence)
+std::vector<uint8_t> ModelBase::toJSON(const String &identity, bool include_timestamp, bool include_sequence)
 {
     JsonDocument doc;
     doc["identity"] = identity;
@@ -16,8 +18,52 @@ String ModelBase::toJSON(const String &identity, bool include_timestamp, bool in
         doc["sequence"] = this->sequence;
     }
 
-    String buffer;
-    serializeJson(doc, buffer);
+    //reserve one byte for the \0 that serializeJson appends and drop it afterwards because the payload size is passed explicitly
+    size_t length = measureJson(doc);
+    std::vector<uint8_t> buffer(length + 1);
+    serializeJson(doc, (char *)buffer.data(), buffer.size());
+    buffer.resize(length);
 
     return buffer;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief encodes the model as binary payload: one byte with the length of the identity, the identity, the model fields in the order of getModelDefinition and optionally timestamp and sequence as uint32. all values are little endian.
+ * @return payload for a data packet; the layout of the fields is advertised with getBinaryFormat
+ */
+std::vector<uint8_t> ModelBase::toBinary(const String &identity, bool include_timestamp, bool include_sequence)
+{
+    std::vector<uint8_t> buffer;
+    BinaryWriter writer(&buffer);
+
+    writer.writeIdentity(identity);
+    this->appendModelBinary(writer);
+
+    if (include_timestamp) {
+        writer.writeUInt32(this->timestamp);
+    }
+    if (include_sequence) {
+        writer.writeUInt32(this->sequence);
+    }
+
+    return buffer;
+}
+
+/**
+ * @brief describes the fields that follow the identity in a binary payload as python struct format string.
+ */
+String ModelBase::getBinaryFormat(bool include_timestamp, bool include_sequence)
+{
+    BinaryWriter writer(nullptr);
+
+    this->appendModelBinary(writer);
+
+    if (include_timestamp) {
+        writer.writeUInt32(this->timestamp);
+    }
+    if (include_sequence) {
+        writer.writeUInt32(this->sequence);
+    }
+
+    return writer.getFormat();
+}
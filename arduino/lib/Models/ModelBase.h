@@ -3,6 +3,9 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <vector>
+
+#include "BinaryWriter.h"
 
 class ModelBase {
     public:
@@ -12,12 +15,16 @@ class ModelBase {
         unsigned long timestamp;
         unsigned long sequence;
 
-        String toJSON(const String &identity, bool include_timestamp, bool include_sequence);
+        std::vector<uint8_t> toJSON(const String &identity, bool include_timestamp, bool include_sequence);
+        std::vector<uint8_t> toBinary(const String &identity, bool include_timestamp, bool include_sequence);
+        String getBinaryFormat(bool include_timestamp, bool include_sequence);
         virtual void getModelDefinition(JsonObject& json) = 0;
 
     protected:
         virtual void appendModelData(JsonDocument& ojb) = 0;
+        //must write the fields in the same order as they are listed in getModelDefinition
+        virtual void appendModelBinary(BinaryWriter& writer) = 0;
 
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -10,4 +10,9 @@ void TemperatureModel::getModelDefinition(JsonObject& json) {
 void TemperatureModel::appendModelData(JsonDocument &obj)
 {
     obj["temperature"] = this->temperature;
+}
+
+void TemperatureModel::appendModelBinary(BinaryWriter &writer)
+{
+    writer.writeFloat(this->temperature);
 }
\ No newline at end of file
@@ -56,7 +56,7 @@ void BluetoothProtocol::destroy()
 }
 
 /**
- * @note we add -1 to the dataSize because we do not want to send the packet with the terminating \x00 byte. we can not add it before because we need to consider the terminating char while handling it in the packet class.
+ * @note the packet is serialised into the tx buffer of the protocol without the terminating \x00 byte, so there is no allocation per packet. the notifications are sent in chunks directly from the tx buffer.
  */
 void BluetoothProtocol::writePacket(std::shared_ptr<Packet> packet)
 {
@@ -65,10 +65,27 @@ void BluetoothProtocol::writePacket(std::shared_ptr<Packet> packet)
         return;
     }
 
-    uint8_t *data = packet->serialize();
-    size_t dataSize = packet->getPacketSize() - 1;
+    size_t dataSize = this->serializeToTxBuffer(packet);
+    this->notifyChunks(this->getTxBuffer(), dataSize);
+}
+
+/**
+ * @brief the client reassembles the packets from the notifications as a byte stream, so the packets are serialised back to back and a notification carries as many of them as fit into the MTU. small packets such as sensor data then share one notification and its BLE_CHUNK_TIMEOUT.
+ */
+void BluetoothProtocol::writePackets(std::vector<std::shared_ptr<Packet>> &packets)
+{
+    if (!this->connected)
+    {
+        return;
+    }
+
+    size_t dataSize = this->serializeToTxBuffer(packets);
+    this->notifyChunks(this->getTxBuffer(), dataSize);
+}
 
-    for (int i = 0; i < dataSize; i += this->maxPayloadSize)
+void BluetoothProtocol::notifyChunks(uint8_t *data, size_t dataSize)
+{
+    for (size_t i = 0; i < dataSize; i += this->maxPayloadSize)
     {
         size_t chunkSize = min(this->maxPayloadSize, dataSize - i);
 
@@ -77,19 +94,11 @@ void BluetoothProtocol::writePacket(std::shared_ptr<Packet> packet)
 
         delay(NET::BLE_CHUNK_TIMEOUT);
     }
-
-    delete[] data;
 }
 
 std::shared_ptr<Packet> BluetoothProtocol::readPacket()
 {
-    if (this->dataCache.empty())
-        return nullptr;
-
-    std::shared_ptr<Packet> packet = this->dataCache.front();
-    this->dataCache.pop();
-
-    return std::move(packet);
+    return this->parser.next();
 }
 
 bool BluetoothProtocol::checkConnection()
@@ -99,10 +108,7 @@ bool BluetoothProtocol::checkConnection()
 
 void BluetoothProtocol::cleanup()
 {
-    while (!this->dataCache.empty())
-    {
-        this->dataCache.pop();
-    }
+    this->parser.reset();
 
     if (this->server)
     {
@@ -114,35 +120,16 @@ void BluetoothProtocol::cleanup()
     }
 }
 
+/**
+ * @brief the client may split a packet over several writes (e.g. when it is larger than the MTU) or send several packets in one write. every write is fed to the packet parser, which keeps the partial packet until the next write; complete packets are taken by readPacket in the main loop, which is woken up by the data signal.
+ */
 void BluetoothProtocol::onWrite(BLECharacteristic *pCharacteristic)
 {
     uint8_t *data = pCharacteristic->getData();
     size_t dataSize = pCharacteristic->getValue().length();
-    size_t index = 0;
-    while (index < dataSize && !Packet::verifyFlag(data[index]))
-    {
-        index++;
-    }
-
-    if (index >= dataSize && dataSize < NET::HEADER::SIZE)
-        return;
-    uint8_t header[NET::HEADER::SIZE];
-    memcpy(header, data + index, NET::HEADER::SIZE);
-
-    std::shared_ptr<Packet> packet = std::make_shared<Packet>();
-    packet->deserializeHeader(header);
-    uint16_t payloadSize = packet->getPayloadSize();
-
-    if (dataSize - NET::HEADER::SIZE < payloadSize)
-        return;
-
-    char payloadBuffer[payloadSize + 1];
-    memcpy(payloadBuffer, data + index + NET::HEADER::SIZE, payloadSize);
-    payloadBuffer[payloadSize] = '\0';
-
-    packet->deserializePayload(payloadBuffer);
 
-    this->dataCache.push(std::move(packet));
+    this->parser.feed(data, dataSize);
+    this->signalData();
 }
 
 void BluetoothProtocol::advertise()
@@ -6,8 +6,8 @@
 #include <BLEUtils.h>
 #include <BLEServer.h>
 #include <BLE2902.h>
-#include <queue>
 #include <memory>
+#include <vector>
 
 #include "ProtocolBase.h"
 #include "Packet.h"
@@ -21,6 +21,7 @@ class BluetoothProtocol: public ProtocolBase, public BLECharacteristicCallbacks,
         void init() override;
         void destroy() override;
         void writePacket(std::shared_ptr<Packet> packet) override;
+        void writePackets(std::vector<std::shared_ptr<Packet>> &packets) override;
         std::shared_ptr<Packet> readPacket() override;
         bool checkConnection() override;
 
@@ -30,13 +31,13 @@ class BluetoothProtocol: public ProtocolBase, public BLECharacteristicCallbacks,
         void advertise();
         void onConnect(BLEServer *pServer);
         void onDisconnect(BLEServer *pServer);
+        void notifyChunks(uint8_t *data, size_t dataSize);
 
         size_t maxPayloadSize;
         Logger *logger;
         BLEServer *server;
         BLEService *service;
         BLECharacteristic *characteristic;
-        std::queue<std::shared_ptr<Packet>> dataCache;
 };
 
 #endif
\ No newline at end of file
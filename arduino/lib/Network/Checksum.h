@@ -0,0 +1,15 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <Arduino.h>
+
+//table driven CRC8 with the parameters of CRC-8/BLUETOOTH which are used for the checksum in the packet header
+class Checksum {
+    public:
+        static uint8_t crc8(const uint8_t* data, size_t length);
+
+    private:
+        static const uint8_t table[256];
+};
+
+#endif
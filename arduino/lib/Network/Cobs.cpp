@@ -0,0 +1,96 @@
+#include <Arduino.h>
+
+#include "Cobs.h"
+
+/**
+ * @class Cobs
+ * @file Cobs.cpp
+ * @brief Encodes and decodes frames with Consistent Overhead Byte Stuffing.
+ *
+ * Every 0x00 byte of the data is replaced by the distance to the next 0x00 byte; the first byte of the frame holds the distance to the first 0x00 byte. A run of 254 bytes without 0x00 costs one extra byte, therefore the overhead is at most 1 byte per 254 bytes. The frame itself is followed by Cobs::DELIMITER which never appears inside an encoded frame, so a receiver that lost bytes continues with the next frame after the next 0x00.
+ *
+ * @cite https://en.wikipedia.org/wiki/Consistent_Overhead_Byte_Stuffing
+ */
+
+/**
+ * @param length number of bytes of the data to encode
+ * @return number of bytes that encode may write at most (without the delimiter)
+ */
+size_t Cobs::maxEncodedSize(size_t length)
+{
+    return length + length / 254 + 1;
+}
+
+/**
+ * @param data bytes to encode
+ * @param length number of bytes in data
+ * @param encoded buffer with at least maxEncodedSize(length) bytes
+ * @return number of encoded bytes without the delimiter
+ */
+size_t Cobs::encode(const uint8_t *data, size_t length, uint8_t *encoded)
+{
+    size_t codeIndex = 0;
+    size_t writeIndex = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (data[i] == DELIMITER)
+        {
+            encoded[codeIndex] = code;
+            codeIndex = writeIndex++;
+            code = 1;
+            continue;
+        }
+
+        encoded[writeIndex++] = data[i];
+        code++;
+
+        if (code == 0xFF)
+        {
+            encoded[codeIndex] = code;
+            codeIndex = writeIndex++;
+            code = 1;
+        }
+    }
+
+    encoded[codeIndex] = code;
+
+    return writeIndex;
+}
+
+/**
+ * @brief decoding never writes more bytes than it has read, so encoded and data may be the same buffer.
+ * @param encoded frame without the delimiter
+ * @param length number of bytes in encoded
+ * @param data buffer with at least length bytes
+ * @return number of decoded bytes; 0 if the frame is corrupted
+ */
+size_t Cobs::decode(const uint8_t *encoded, size_t length, uint8_t *data)
+{
+    size_t readIndex = 0;
+    size_t writeIndex = 0;
+
+    while (readIndex < length)
+    {
+        uint8_t code = encoded[readIndex];
+
+        if (code == DELIMITER || readIndex + code > length)
+            return 0;
+
+        readIndex++;
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            data[writeIndex++] = encoded[readIndex++];
+        }
+
+        // a code below 0xFF stands for a 0x00 byte, except at the end of the frame
+        if (code != 0xFF && readIndex < length)
+        {
+            data[writeIndex++] = DELIMITER;
+        }
+    }
+
+    return writeIndex;
+}
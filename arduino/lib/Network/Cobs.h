@@ -0,0 +1,16 @@
+#ifndef COBS_H
+#define COBS_H
+
+#include <Arduino.h>
+
+//consistent overhead byte stuffing; an encoded frame contains no 0x00 byte, so 0x00 can delimit frames on a byte stream
+class Cobs {
+    public:
+        static size_t maxEncodedSize(size_t length);
+        static size_t encode(const uint8_t* data, size_t length, uint8_t* encoded);
+        static size_t decode(const uint8_t* encoded, size_t length, uint8_t* data);
+
+        static const uint8_t DELIMITER = 0x00;
+};
+
+#endif
@@ -11,14 +11,14 @@
 #include "PacketRelay.h"
 #include "Definitions.h"
 
-IntegrityMiddleware::IntegrityMiddleware(): outgoingSequence(0), expectedSequence(0), ackSendEnabled(NET::SEND_ACK_PACKETS) {
+IntegrityMiddleware::IntegrityMiddleware(): outgoingSequence(0), unacknowledgedPackets(0), acknowledgementDue(0), ackSendEnabled(NET::SEND_ACK_PACKETS), sendWindow(NET::SEND_WINDOW_POLICY) {
     this->logger = Logger::getInstance();
     this->relay = PacketRelay::getInstance();
 }
 
 IntegrityMiddleware::~IntegrityMiddleware() {
-    this->outOfOrderPackets.clear();
-    this->packetsForResend.clear();
+    this->reorderBuffer.clear();
+    this->sendWindow.clear();
 }
 
 /**
@@ -39,10 +39,10 @@ std::vector<std::shared_ptr<Packet>> IntegrityMiddleware::processIncomingData(st
         return output;
     }
 
-    //we got a bad packet that either has a wrong checksum, has a wrong flag (start byte) or has no data, therefore we "drop" the packet and request a resend with
+    //we got a bad packet that either has a wrong checksum, has a wrong flag (start byte) or has no data, therefore we "drop" the packet and send an ACK right away so that the client sees which sequences are missing
     if (!packet->verifyGoodPacket()) {
 
-        this->sendAckPacket(packet->getSequence(), true);
+        this->scheduleAcknowledgement(true);
 
         return output;//empty
     } else if (packet->getMethod() == NET::HEADER::METHOD_ACKNOWLEDGEMENT) {
@@ -50,23 +50,22 @@ std::vector<std::shared_ptr<Packet>> IntegrityMiddleware::processIncomingData(st
         this->processAcknowledgement(packet);
 
         return output; //returning since we do not progress the data any further; empty
-    } else if (packet->getMethod() != NET::HEADER::METHOD_HEARTBEAT) {
-        //already ruled out ACK method too
-        //send ACK to client that the packet is ok
-        this->sendAckPacket(packet->getSequence(), false);
-
+    } else if (packet->getMethod() == NET::HEADER::METHOD_HEARTBEAT) {
         //we do return here early for heartbeat packet because we want to know if the mayako-core is still alive but not make any sequence tracking
         output.push_back(packet);
         return output;
-    } else if (this->compareSequenceWithOverflow(packet->getSequence(), this->expectedSequence)) {
-        //the received packet is below the sequence that we expect. it also is not a packet that we need for reordering because we do not increment the expcetedSequence counter if there is a packet with a too high sequence. Packets with "too high sequence" are saved in outOfOrderPackets and are only used when the order can be zipped. Only then will the sequence be increased by the count of "jumps" we did with filling the order gap. It might be a corrupted packet, a double packet or a packet that we "jumped over" because of too many tries or overflow (we only track back packets as long as the resendPacket map is not too big, because then we step-by-step "jump over" the gaps and forget about the missing packets).
+    } else if (this->compareSequenceWithOverflow(packet->getSequence(), this->reorderBuffer.getExpectedSequence())) {
+        //the received packet is below the sequence that we expect. it also is not a packet that we need for reordering because we do not increment the expcetedSequence counter if there is a packet with a too high sequence. Packets with "too high sequence" are saved in reorderBuffer and are only used when the order can be zipped. Only then will the sequence be increased by the count of "jumps" we did with filling the order gap. It might be a corrupted packet, a double packet or a packet that we "jumped over" because of too many tries or overflow (we only track back packets as long as the resendPacket map is not too big, because then we step-by-step "jump over" the gaps and forget about the missing packets).
+        //a double packet means that our ACK was probably lost, so we repeat it right away
+        this->scheduleAcknowledgement(true);
+
         return output;//empty
 
     }
     /** packet from here on:
     - they are not corrupted
-    - they are not ACK packets
-    - we sent ACK if it is a good packet
+    - they are not ACK or HEARTBEAT packets
+    - they are acknowledged with the next (delayed) ACK
     */
     this->processValidPacket(packet, output);
     
@@ -74,75 +73,32 @@ std::vector<std::shared_ptr<Packet>> IntegrityMiddleware::processIncomingData(st
 }
 
 void IntegrityMiddleware::processValidPacket(std::shared_ptr<Packet> packet, std::vector<std::shared_ptr<Packet>> &output) {
-    if (packet->getSequence() == this->expectedSequence) {
+    if (packet->getSequence() == this->reorderBuffer.getExpectedSequence()) {
         /**
-         * the current packet has the sequence that we expect therefore we mark it as output, but also check the other packets in outOfOrderPackets. here we put the current packet in the output vector because we are sure that it is not corrupted and in order.
+         * the current packet has the sequence that we expect therefore we mark it as output together with the packets in reorderBuffer that directly follow it. here we put the current packet in the output vector because we are sure that it is not corrupted and in order.
          */
-        output.push_back(packet);
-        this->processOutOfOrderPackets(output);
+        this->reorderBuffer.deliver(packet, output);
 
-    } else if (this->outOfOrderPackets.size() >= NET::OUT_OF_ORDER_PACKET_MAX_SIZE) {
-        //here we look at outOfOrderPackets: if the size is higher then a set maximum, we "jump over the hole" in the sequence and take the packet with the next nearest sequence. We do this with only one paket, to keep the loss low.
-        this->handlePacketOverflow(output);
-        this->processOutOfOrderPackets(output);
-        //TODO: would be good to zip here again. right?
-    } else {
-        //that packet we received is above the sequence we expected, therefore we are missing packets. first, we send an ACK retry packet for the packet sequences that are between the expectedSequence and the current packet sequence. then we save the current packet in outOfOrderPackets for later retrieval.
-        this->requestMissingPackets(packet);
-    }
-}
+        //an empty reorder buffer means that nothing is missing, so the ACK may wait for the next packet or the ACK delay
+        this->scheduleAcknowledgement(!this->reorderBuffer.isEmpty());
 
-void IntegrityMiddleware::processOutOfOrderPackets(std::vector<std::shared_ptr<Packet>> &output) {
-    //TODO while true loop could be problematic if things go bad
-    while (true) {
-        //we increment the expectedsequence and look in the map outOfOrderPackets if they are there. we look as long as we can find packets then break. we also pay attention to overflow in uint16_t
-        this->expectedSequence = this->incrementSequence(this->expectedSequence);
-        auto it = this->outOfOrderPackets.find(this->expectedSequence);
-        if (it != this->outOfOrderPackets.end()) {
-            std::shared_ptr<Packet> packet = it->second;
-            
-            output.push_back(packet);
-
-            this->outOfOrderPackets.erase(it);
-        } else {
-            break;
-        }
+    } else {
+        //that packet we received is above the sequence we expected, therefore we are missing packets. first, we save the current packet in reorderBuffer for later retrieval. then we send one ACK whose bitmap tells the client which packets between the expectedSequence and the current packet sequence are missing.
+        this->requestMissingPackets(packet, output);
     }
 }
 
-void IntegrityMiddleware::handlePacketOverflow(std::vector<std::shared_ptr<Packet>> &output) {
-    //TODO while true loop could be problematic if things go bad
-    //we realised that the recevied packet does not have the desired sequence and the map outOfOrderPackets has exceeded the limit we set. so we decide to "jump over the gap". we increase the sequence and check the map as long as we can not find a "next" packet. the packets in the gap are lost and no longer tracked.
-    uint16_t currentExpectedSequence = this->incrementSequence(this->expectedSequence);
-    while (true) {
-        auto it = this->outOfOrderPackets.find(currentExpectedSequence);
-        if (it != this->outOfOrderPackets.end()) {
-            std::shared_ptr<Packet> packet = it->second;
-            
-            output.push_back(packet);
-            this->outOfOrderPackets.erase(it);
-            
-            break;
-        } else {
-            //at this sequence, we could not find a packet so we look at the next seqeunce.
-            currentExpectedSequence = this->incrementSequence(currentExpectedSequence);
-        }
+void IntegrityMiddleware::requestMissingPackets(std::shared_ptr<Packet> packet, std::vector<std::shared_ptr<Packet>> &output) {
+    if (!this->reorderBuffer.store(packet)) {
+        //the packet is too far ahead for the bitmap, so the missing packets can not be requested anymore; we continue with this packet
+        this->reorderBuffer.resynchronise(packet, output);
     }
-}
 
-void IntegrityMiddleware::requestMissingPackets(std::shared_ptr<Packet> packet) {
-    uint16_t sequenceCounter = this->expectedSequence;
-    //here we must be cautious because the sequence can overflow if we have many packets to send and many sensors. sequence overflows after 65536 packets. is this safe then?
-    //the received packet is valid but is higher than expected. therefore we send ACK packets for the packets between the expectedSequence and the sequence of the packet that we recvied instead.
-    while (sequenceCounter != packet->getSequence()) {
-        this->sendAckPacket(sequenceCounter, true);
-        sequenceCounter = this->incrementSequence(sequenceCounter);
-    }
-    this->outOfOrderPackets[packet->getSequence()] = packet;
+    this->scheduleAcknowledgement(true);
 }
 
 /**
- * @brief compare the incoming and expected sequence considering uint16_t overflow
+ * @brief compare the incoming and expected sequence with serial number arithmetic: i1 is before i2 if i2 - i1 is between 1 and 2^15 - 1 modulo 2^16. This is correct across the wrap, e.g. 65530 is before 3, whereas comparing the plain values is not.
  * @cite https://www.rfc-editor.org/rfc/rfc1982#section-3.2
  * @param i1 is the incomiongSequence
  * @param i2 is the expectedSequence
@@ -150,26 +106,45 @@ void IntegrityMiddleware::requestMissingPackets(std::shared_ptr<Packet> packet)
  * @example if we expect a packet with the sequence 77 (expectedSequence) but receive a packet with sequence 67, we can certainly say that it is a double, corrupt BUT NOT out of order because we ONLy increment the expectedSequence if the order is intact. These kinds of packets can be savely dropped.
  */
 bool IntegrityMiddleware::compareSequenceWithOverflow(uint16_t i1, uint16_t i2) {
-    if (i1 == i2) return false; //we want to make sure that equal packets are passed further
-    bool condition = (i1 < i2) && ((i2 - i1) < NET::SEQUENCE_MAX_NUMBER_SIZE);
-    return condition;
+    //the difference of exactly 2^15 is undefined in RFC 1982; the packet is not treated as old then and ends up in requestMissingPackets
+    return (int16_t)(i1 - i2) < 0;
 }
 
 /**
- * @brief increment the sequence while keeping an eye on overflow
+ * @brief increment the outgoing sequence; it wraps after 2^32 packets, of which the short sequence mode only sends the lower 16 bits
  * @param sequence to increment
  * @return the incremented value for sequence
  */
-uint16_t IntegrityMiddleware::incrementSequence(uint16_t seq) {
-    return (seq + 1) % (NET::SEQUENCE_MAX_NUMBER_SIZE + 1);
+uint32_t IntegrityMiddleware::incrementSequence(uint32_t seq) {
+    return seq + 1;
 }
 
+/**
+ * @brief processes an ACK packet of the client for packets in the send window. the client sends the binary format of NET::ACK_PAYLOAD_SIZE with the next expected sequence and a bitmap, where bit i means that the packet sequence + 1 + i was received. json ACKs of older clients are still accepted: the cumulative format {"seq_num": next expected sequence, "sack": bitmap} or the legacy format {"seq_num": sequence, "retry": bool} for a single packet.
+ */
 void IntegrityMiddleware::processAcknowledgement(std::shared_ptr<Packet> packet) {
+    const uint8_t *payload = (const uint8_t *)packet->getPayloadView();
+    size_t length = packet->getPayloadLength();
+
+    //a json ACK is always longer than the binary one because "seq_num" alone has more bytes, so the length tells the formats apart
+    if (length == NET::ACK_PAYLOAD_SIZE) {
+        uint16_t sequence = (payload[0] << 8) | payload[1];
+        uint32_t bitmap = ((uint32_t)payload[2] << 24) | ((uint32_t)payload[3] << 16) | ((uint32_t)payload[4] << 8) | payload[5];
+        this->processSelectiveAcknowledgement(sequence, bitmap);
+        return;
+    }
+
     JsonDocument doc;
-    deserializeJson(doc, packet->getPayload().get());
+    deserializeJson(doc, packet->getPayloadView(), length);
 
-    bool retry = doc["retry"].as<bool>();
     uint16_t sequence = doc["seq_num"].as<uint16_t>();
+
+    if (doc["sack"].is<uint32_t>()) {
+        this->processSelectiveAcknowledgement(sequence, doc["sack"].as<uint32_t>());
+        return;
+    }
+
+    bool retry = doc["retry"].as<bool>();
     if (retry) {
         this->resendPacketForResend(sequence);
     } else {
@@ -177,31 +152,101 @@ void IntegrityMiddleware::processAcknowledgement(std::shared_ptr<Packet> packet)
     }
 }
 
-std::shared_ptr<Packet> IntegrityMiddleware::processOutgoingData(std::shared_ptr<Packet> packet) {
+/**
+ * @brief frees all packets before nextSequence and the packets marked in the bitmap. the packets in the gaps below the highest marked packet are lost and are retransmitted once without waiting for the timeout; further retransmissions of them depend on the timeout.
+ * @param nextSequence the client received all packets before this sequence
+ * @param bitmap bit i is set if the client received the packet nextSequence + 1 + i
+ */
+void IntegrityMiddleware::processSelectiveAcknowledgement(uint16_t nextSequence, uint32_t bitmap) {
+    unsigned long now = millis();
+    unsigned long roundTripTime;
+    bool measured = this->sendWindow.acknowledgeUpTo(nextSequence, now, roundTripTime);
+
+    for (uint8_t i = 0; i < NET::SACK_BITS; i++) {
+        if ((bitmap & ((uint32_t)1 << i)) == 0) continue;
+
+        unsigned long sackRoundTripTime;
+        if (this->sendWindow.acknowledge(nextSequence + 1 + i, now, sackRoundTripTime)) {
+            roundTripTime = measured ? min(roundTripTime, sackRoundTripTime) : sackRoundTripTime;
+            measured = true;
+        }
+    }
+
+    //the newest acknowledged packet gives the smallest round trip time; older packets also include the time they waited for a delayed ACK
+    if (measured) {
+        this->retransmissionTimer.sample(roundTripTime);
+    }
+
+    if (bitmap == 0) return;
+
+    uint8_t highestBit = 31 - __builtin_clz(bitmap);
+    for (uint8_t i = 0; i <= highestBit; i++) {
+        uint16_t missingSequence = nextSequence + i;
+        if (i == 0 || (bitmap & ((uint32_t)1 << (i - 1))) == 0) {
+            this->sendWindow.requestFastRetransmit(missingSequence);
+        }
+    }
+}
+
+/**
+ * @brief must be called before processOutgoingData; the networkmanager keeps the packet in the output queue as long as this returns false.
+ * @param packet the next packet in the output queue
+ * @return false if the slot of the packet in the send window is taken by a packet that the policy of the window does not allow to drop
+ */
+bool IntegrityMiddleware::canSend(std::shared_ptr<Packet> &packet) {
+    if (!this->ackSendEnabled || !this->isKept(packet)) return true;
+
+    return this->sendWindow.reserve(packet, this->outgoingSequence);
+}
+
+/**
+ * @brief gives the packet its node identity and sequence and keeps it in the send window if its delivery class requires it.
+ * @param keep false writes a packet without keeping it, e.g. when canSend returned false and the packet must leave anyway before the format of the link changes
+ */
+std::shared_ptr<Packet> IntegrityMiddleware::processOutgoingData(std::shared_ptr<Packet> packet, bool keep) {
     packet->setNodeIdentity(MC_NAME);
     
-    //we do not want to track ACK or HEARTBEAT packets
-    if (packet->getMethod() == NET::HEADER::METHOD_ACKNOWLEDGEMENT || packet->getMethod() == NET::HEADER::METHOD_HEARTBEAT) return packet;
+    //we do not want to track ACK, HEARTBEAT or PARITY packets
+    if (!this->isTracked(packet)) return packet;
     
     packet->setSequence(this->outgoingSequence);
+    //the sequence also increments without ACK packets because the parity packets refer to the data packets by their sequence
+    this->outgoingSequence = this->incrementSequence(this->outgoingSequence);
 
+    if (keep && this->ackSendEnabled && this->isKept(packet)) {
+        //we save the packet to resend it if we get a ACK packet with the corresponding sequenceNumber and retry true - this case means that we need to resend the packet with the corresponding sequence number inlcuded in the ACK packet payload. if we get retry false, we can savely free the slot in the send window. the slot of this sequence is free because canSend reserved it.
+        this->sendWindow.insert(packet, millis());
+    }
 
-    if (this->ackSendEnabled) {
-        //we save the packet to resend it if we get a ACK packet with the corresponding sequenceNumber and retry true - this case means that we need to resend the packet with the corresponding sequence number inlcuded in the ACK packet payload. if we get retry false, we can savely delete the entry in packetsForResend map.
-        //check if there is already an entry with the sequence to avoid memory leaks.
-        auto sequence = packet->getSequence();
-        auto it = this->packetsForResend.find(sequence);
-        if (it != this->packetsForResend.end()) {
-            this->packetsForResend.erase(it);
-        }
+    if (packet->getMethod() == NET::HEADER::METHOD_DATA || packet->getMethod() == NET::HEADER::METHOD_BATCH) {
+        //the parity packet is queued behind the packets that are already waiting; it has no sequence and is not kept for a resend
+        this->relay->send(this->parityEncoder.add(packet));
+    }
 
-        this->packetsForResend[packet->getSequence()] = packet;
+    return packet;
+}
 
-        this->outgoingSequence = this->incrementSequence(this->outgoingSequence);
+/**
+ * @brief collects the packets in the send window that were not acknowledged within the retransmission timeout or that the client reported as missing. the networkmanager writes them before the output queue so that a lost command response is not stuck behind new sensor data.
+ * @param output the packets to retransmit are appended; they already have their sequence and node identity
+ */
+void IntegrityMiddleware::collectRetransmissions(std::vector<std::shared_ptr<Packet>> &output) {
+    if (!this->ackSendEnabled) return;
+
+    if (this->sendWindow.collectRetransmissions(millis(), this->retransmissionTimer.getTimeout(), output)) {
+        this->retransmissionTimer.backoff();
     }
+}
 
+bool IntegrityMiddleware::isTracked(std::shared_ptr<Packet> &packet) {
+    return packet->getMethod() != NET::HEADER::METHOD_ACKNOWLEDGEMENT && packet->getMethod() != NET::HEADER::METHOD_HEARTBEAT && packet->getMethod() != NET::HEADER::METHOD_PARITY;
+}
 
-    return packet;
+/**
+ * @return true if the packet is kept in the send window until it is acknowledged; BEST_EFFORT packets such as sensor data only get a sequence so that sensor data does not fill the window and cost memory and retransmissions
+ */
+bool IntegrityMiddleware::isKept(std::shared_ptr<Packet> &packet) {
+    return this->isTracked(packet) && packet->getDeliveryClass() != NET::DeliveryClass::BEST_EFFORT;
 }
 
 void IntegrityMiddleware::enableAckPackets() {
@@ -210,49 +255,106 @@ void IntegrityMiddleware::enableAckPackets() {
 
 void IntegrityMiddleware::disableAckPackets() {
     this->ackSendEnabled = false;
+    this->unacknowledgedPackets = 0;
+    this->sendWindow.clear();
+    this->retransmissionTimer.reset();
+}
+
+/**
+ * @brief configures the XOR parity packets for data packets; a started group is dropped.
+ * @param groupSize data packets per parity packet; 0 disables it
+ */
+void IntegrityMiddleware::setForwardErrorCorrection(uint8_t groupSize) {
+    this->parityEncoder.configure(groupSize);
+}
+
+void IntegrityMiddleware::getSendWindowStatistics(JsonObject &json) {
+    this->sendWindow.getStatistics(json);
+    this->retransmissionTimer.getStatistics(json);
+}
+
+/**
+ * @return received packets that wait in the reorder buffer for a missing sequence
+ */
+size_t IntegrityMiddleware::getReorderBufferSize() {
+    return this->reorderBuffer.size();
+}
+
+/**
+ * @return sent packets in the send window that are neither acknowledged nor given up
+ */
+size_t IntegrityMiddleware::getInFlight() {
+    return this->sendWindow.getInFlight();
+}
+
+/**
+ * @brief notes that the client must receive an ACK. ACK packets are delayed and coalesced: one ACK confirms all packets received in order plus a bitmap of the packets received after a gap, so it is sent after NET::ACK_EVERY packets or NET::ACK_DELAY milli seconds (see flushAcknowledgement), whichever comes first.
+ * @param immediate sends the ACK now, e.g. because a packet is missing and the client should retransmit it as soon as possible
+ */
+void IntegrityMiddleware::scheduleAcknowledgement(bool immediate) {
+    if (this->unacknowledgedPackets == 0) {
+        this->acknowledgementDue = millis() + NET::ACK_DELAY;
+    }
+    this->unacknowledgedPackets++;
+
+    if (immediate || this->unacknowledgedPackets >= NET::ACK_EVERY) {
+        this->sendAckPacket();
+    }
+}
+
+/**
+ * @brief sends a pending ACK when the ACK delay is over; called by the networkmanager with each iteration.
+ */
+void IntegrityMiddleware::flushAcknowledgement() {
+    if (this->unacknowledgedPackets > 0 && (long)(millis() - this->acknowledgementDue) >= 0) {
+        this->sendAckPacket();
+    }
 }
 
 /**
- * @brief This functions sends a ACK packet to the client indicating that a packet was received or not.
+ * @return milli seconds until a delayed ACK must be sent or a packet in the send window must be retransmitted; UTIL::NO_DEADLINE if neither is pending
+ */
+unsigned long IntegrityMiddleware::getTimeToNextEvent(unsigned long now) {
+    unsigned long time = UTIL::NO_DEADLINE;
+
+    if (this->unacknowledgedPackets > 0) {
+        time = (long)(this->acknowledgementDue - now) > 0 ? this->acknowledgementDue - now : 0;
+    }
+
+    if (this->ackSendEnabled) {
+        time = min(time, this->sendWindow.getTimeToRetransmission(now, this->retransmissionTimer.getTimeout()));
+    }
+
+    return time;
+}
+
+/**
+ * @brief This functions sends a cumulative ACK packet to the client.
  * 
- * The ACK packet has two functions: 1) confirm that a packet was received 2) indicate that a packet was not received. The second case maybe if a packet was lost on the way or when a sequence was received that indicates that there is a missing packet.
- * @param sequenceNumber of the packet sent or missing
- * @param retry true indicates the packet was received, false not
+ * The payload holds the next sequence that we expect; all packets before it were received. Bit i of the bitmap is set if the packet sequence + 1 + i is waiting in reorderBuffer. Every sequence between the expected one and the highest bit set that is not marked is missing and the client should retransmit it, so a burst loss needs only one ACK packet. The payload is binary (see NET::ACK_PAYLOAD_SIZE) because ACKs are sent for every other packet.
  */
-void IntegrityMiddleware::sendAckPacket(uint16_t sequenceNumber, bool retry) {
-    JsonDocument doc;
-    doc["seq_num"] = sequenceNumber;
-    doc["retry"] = retry;
-
-    /** 
-     * @brief Computes the length of the minified JSON document that serializeJson() produces, excluding the null-terminator.
-     * @cite https://arduinojson.org/v7/api/json/measurejson/
-     * */
-    size_t bufferSize = measureJson(doc) + 1;
-    char buffer[bufferSize]; // do inplace; no pointer needed unless we are moving it between functions
-    serializeJson(doc, buffer, bufferSize);
-    
-    this->relay->ack(buffer);
+void IntegrityMiddleware::sendAckPacket() {
+    this->relay->ack(this->reorderBuffer.getExpectedSequence(), this->reorderBuffer.getBitmap());
+
+    this->unacknowledgedPackets = 0;
 }
 
 /**
- * @brief Deletes the entries in packetsForResend map.
- * @param sequenceNumber is the sequenceNumber that is transfered in the body of a ACK packet and is also a key in packetsForResend.
+ * @brief Frees the slot of the packet in the send window and updates the retransmission timeout with the measured round trip time.
+ * @param sequenceNumber is the sequenceNumber that is transfered in the body of a ACK packet.
  */
 void IntegrityMiddleware::deletePacketForResend(uint16_t sequenceNumber) {
-    auto it = this->packetsForResend.find(sequenceNumber);
-    if (it != this->packetsForResend.end()) {
-        this->packetsForResend.erase(it);
+    unsigned long roundTripTime;
+
+    if (this->sendWindow.acknowledge(sequenceNumber, millis(), roundTripTime)) {
+        this->retransmissionTimer.sample(roundTripTime);
     }
 }
 
 /**
- * @brief If an ACK packet indicates that a packet must be resent, the sequenceNumber queries the corresponding packet so that it can directly be resent.
- * @param sequenceNumber is the sequenceNumber that is transfered in the body of a ACK packet and is also a key in packetsForResend.
+ * @brief If an ACK packet indicates that a packet must be resent, the corresponding packet is marked in the send window and resent with the next call of collectRetransmissions.
+ * @param sequenceNumber is the sequenceNumber that is transfered in the body of a ACK packet.
  */
 void IntegrityMiddleware::resendPacketForResend(uint16_t sequenceNumber) {
-    auto it = this->packetsForResend.find(sequenceNumber);
-    if (it != this->packetsForResend.end()) {
-        this->sendAckPacket(sequenceNumber, true);
-    }    
+    this->sendWindow.requestResend(sequenceNumber);
 }
@@ -12,6 +12,10 @@
 #include "Packet.h"
 #include "Logger.h"
 #include "PacketRelay.h"
+#include "SendWindow.h"
+#include "ReorderBuffer.h"
+#include "ParityEncoder.h"
+#include "RetransmissionTimer.h"
 #include "Definitions.h"
 
 //this class stands between the networkmanager and the actual protocol implementations and is responsible for sending ACK packet, tracking sequence, checksum checks and building the packages
@@ -21,39 +25,52 @@ class IntegrityMiddleware {
         ~IntegrityMiddleware();
 
         std::vector<std::shared_ptr<Packet>> processIncomingData(std::shared_ptr<Packet> packet);
-        std::shared_ptr<Packet> processOutgoingData(std::shared_ptr<Packet> packet);
+        bool canSend(std::shared_ptr<Packet> &packet);
+        std::shared_ptr<Packet> processOutgoingData(std::shared_ptr<Packet> packet, bool keep = true);
+        void collectRetransmissions(std::vector<std::shared_ptr<Packet>> &output);
+        void flushAcknowledgement();
+        unsigned long getTimeToNextEvent(unsigned long now);
         void enableAckPackets();
         void disableAckPackets();
+        void getSendWindowStatistics(JsonObject &json);
+        size_t getReorderBufferSize();
+        size_t getInFlight();
+        void setForwardErrorCorrection(uint8_t groupSize);
 
     private:
         Logger *logger;
         PacketRelay *relay;
 
     // INCOMING DATA
-        /* this is the last sequence where we receveived a in-order ACK packet. */
-        uint16_t expectedSequence;
-        /* packets that are received but have a higher sequence than expected are saved here until the expected packet arives. if the size of the map grows beyond a maximum size which still must be evaluated, we retrieve the next nearest packet to expectedSequence and increment expectedSequence by one, expecting the next higher sequence. */
-        std::map<uint16_t, std::shared_ptr<Packet>> outOfOrderPackets;
+        /* packets that are received but have a higher sequence than expected are saved here until the expected packet arives. the buffer also holds the expected sequence. a gap is only given up when a packet arrives that is too far ahead for the buffer; until then the missing packets are requested with the bitmap of the ACK. */
+        ReorderBuffer reorderBuffer;
+        /* number of received packets that are not acknowledged yet and the time when the delayed ACK for them must be sent. */
+        uint16_t unacknowledgedPackets;
+        unsigned long acknowledgementDue;
 
         bool compareSequenceWithOverflow(uint16_t incomingSequence, uint16_t expectedSequence);
         void processAcknowledgement(std::shared_ptr<Packet> packet);
+        void processSelectiveAcknowledgement(uint16_t nextSequence, uint32_t bitmap);
         void processValidPacket(std::shared_ptr<Packet> packet, std::vector<std::shared_ptr<Packet>> &output);
-        void processOutOfOrderPackets(std::vector<std::shared_ptr<Packet>> &output);
-        void handlePacketOverflow(std::vector<std::shared_ptr<Packet>> &output);
-        void requestMissingPackets(std::shared_ptr<Packet> packet);  
+        void requestMissingPackets(std::shared_ptr<Packet> packet, std::vector<std::shared_ptr<Packet>> &output);
+        void scheduleAcknowledgement(bool immediate);
 
     // OUTGOING DATA
         /**
-         * Packets for resend is a map the saves packets that are not ACK that were already sent over the network. The IntegrityManager keeps them until a corresponding ACK returns which indicates wether the packet must be resent or not. If it must not be resent, the entry can be safely deleted from the map.
+         * The send window saves RELIABLE and LATEST_VALUE packets (see NET::DeliveryClass) that were already sent over the network. The IntegrityManager keeps them until a corresponding ACK returns which indicates wether the packet must be resent or not. If it must not be resent, the slot is freed. The window has a fixed size, see SendWindow for what happens when it is full.
          */
-        std::map<uint16_t, std::shared_ptr<Packet>> packetsForResend;
-        uint16_t outgoingSequence;
+        SendWindow sendWindow;
+        RetransmissionTimer retransmissionTimer;
+        ParityEncoder parityEncoder;
+        uint32_t outgoingSequence;
         bool ackSendEnabled;
     
-        void sendAckPacket(uint16_t sequenceNumber, bool retry);
+        void sendAckPacket();
         void deletePacketForResend(uint16_t sequenceNumber);
         void resendPacketForResend(uint16_t sequenceNumber);
-        uint16_t incrementSequence(uint16_t seq);
+        uint32_t incrementSequence(uint32_t seq);
+        bool isTracked(std::shared_ptr<Packet> &packet);
+        bool isKept(std::shared_ptr<Packet> &packet);
 };
 
 #endif
\ No newline at end of file
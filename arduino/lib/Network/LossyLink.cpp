@@ -0,0 +1,301 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "LossyLink.h"
+#include "ProtocolBase.h"
+#include "Packet.h"
+#include "Config.h"
+
+/**
+ * @class LossyLink
+ * @file LossyLink.cpp
+ * @brief Wraps the current protocol and drops, duplicates, reorders, corrupts and delays packets in both directions with the probabilities and delays of LossyLinkImpairments (NET::LOSSY_LINK_* unless set otherwise), so that IntegrityMiddleware (ACKs, retransmissions, reorder buffer, parity packets) can be evaluated without a real radio loss.
+ *
+ * The NetworkManager routes the current protocol through this class in builds with LOSSY_LINK=1; the host harness in test/support puts it between two IntegrityMiddleware instances and sweeps the impairments. All random decisions come from a xorshift32 generator with a fixed seed, so the same sequence of packets is impaired in the same way on every run. A corrupted packet is serialised, one payload byte is flipped and the bytes are parsed again, therefore it keeps its header and fails the checksum on the receiving side like a packet with a bit error. Delayed packets are delivered in order when their time is up; they wait in a queue in this class and are written or returned with the next call of writePacket or readPacket, which the NetworkManager makes with each iteration.
+ */
+LossyLink::LossyLink(uint32_t seed, LossyLinkImpairments impairments) : ProtocolBase(NET::LOSSY_LINK_NAME, NET::MAX_BUFFER_SIZE), protocol(nullptr), seed(seed), randomState(seed != 0 ? seed : 1), impairments(impairments), droppedPackets(0), duplicatedPackets(0), reorderedPackets(0), corruptedPackets(0), queuedHighWater(0) {}
+
+/**
+ * @brief sets the protocol that is impaired; the packets that wait in the link are dropped when the protocol changes because they belong to the old connection.
+ */
+void LossyLink::setProtocol(ProtocolBase *protocol)
+{
+    if (this->protocol == protocol)
+        return;
+
+    this->clear();
+    this->protocol = protocol;
+}
+
+/**
+ * @brief changes the impairments for the packets that pass the link from now on; packets that are already delayed keep their release time.
+ */
+void LossyLink::setImpairments(LossyLinkImpairments impairments)
+{
+    this->impairments = impairments;
+}
+
+//the wrapped protocol is initialised and destroyed by the networkmanager
+void LossyLink::init() {}
+
+void LossyLink::destroy()
+{
+    this->clear();
+}
+
+void LossyLink::writePacket(std::shared_ptr<Packet> packet)
+{
+    unsigned long now = millis();
+
+    this->impair(std::move(packet), this->outgoing, now);
+    this->writeDue(now);
+}
+
+void LossyLink::writePackets(std::vector<std::shared_ptr<Packet>> &packets)
+{
+    unsigned long now = millis();
+
+    for (std::shared_ptr<Packet> &packet : packets)
+    {
+        this->impair(packet, this->outgoing, now);
+    }
+    this->writeDue(now);
+}
+
+/**
+ * @return the next received packet whose delay is over; nullptr if there is none
+ */
+std::shared_ptr<Packet> LossyLink::readPacket()
+{
+    if (this->protocol == nullptr)
+        return nullptr;
+
+    unsigned long now = millis();
+
+    // the outgoing packets are also released here because readPacket is called with every iteration, writePacket only when there is something to send
+    this->writeDue(now);
+
+    // everything the protocol received is taken at once, otherwise a delayed packet would hold back the packets behind it in the protocol for one call each
+    std::shared_ptr<Packet> packet;
+    while ((packet = this->protocol->readPacket()) != nullptr)
+    {
+        this->impair(std::move(packet), this->incoming, now);
+    }
+    this->releaseHeld(this->incoming, now);
+
+    if (this->incoming.queue.empty() || (long)(now - this->incoming.queue.front().releaseAt) < 0)
+        return nullptr;
+
+    packet = std::move(this->incoming.queue.front().packet);
+    this->incoming.queue.pop_front();
+
+    return packet;
+}
+
+bool LossyLink::checkConnection()
+{
+    return this->protocol != nullptr && this->protocol->checkConnection();
+}
+
+/**
+ * @return packets that wait in the wrapped protocol plus the received packets that are delayed or held by the link
+ */
+size_t LossyLink::getPendingPackets()
+{
+    if (this->protocol == nullptr)
+        return 0;
+
+    return this->protocol->getPendingPackets() + this->incoming.queue.size() + (this->incoming.held != nullptr ? 1 : 0);
+}
+
+/**
+ * @return the poll interval of the wrapped protocol, or less if a delayed or held packet must be released earlier; the wrapped protocol signals the received data itself
+ */
+unsigned long LossyLink::getPollInterval()
+{
+    if (this->protocol == nullptr)
+        return UTIL::NO_DEADLINE;
+
+    unsigned long now = millis();
+
+    return min(this->protocol->getPollInterval(), min(this->getTimeToRelease(this->outgoing, now), this->getTimeToRelease(this->incoming, now)));
+}
+
+LossyLinkStatistics LossyLink::getStatistics()
+{
+    return {
+        this->seed,
+        this->droppedPackets,
+        this->duplicatedPackets,
+        this->reorderedPackets,
+        this->corruptedPackets,
+        this->outgoing.queue.size() + this->incoming.queue.size(),
+        this->queuedHighWater
+    };
+}
+
+void LossyLink::getStatistics(JsonObject &json)
+{
+    LossyLinkStatistics statistics = this->getStatistics();
+
+    json["seed"] = statistics.seed;
+    json["dropped"] = statistics.droppedPackets;
+    json["duplicated"] = statistics.duplicatedPackets;
+    json["reordered"] = statistics.reorderedPackets;
+    json["corrupted"] = statistics.corruptedPackets;
+    json["queued"] = statistics.queuedPackets;
+    json["queued_high_water"] = statistics.queuedHighWater;
+}
+
+/**
+ * @brief decides what happens to one packet. the decisions are made in a fixed order so that the same seed always gives the same result.
+ */
+void LossyLink::impair(std::shared_ptr<Packet> packet, Direction &direction, unsigned long now)
+{
+    if (this->chance(this->impairments.loss))
+    {
+        this->droppedPackets++;
+        return;
+    }
+
+    if (this->chance(this->impairments.corrupt))
+    {
+        packet = this->corrupt(packet);
+    }
+
+    bool duplicate = this->chance(this->impairments.duplicate);
+
+    if (direction.held == nullptr && this->chance(this->impairments.reorder))
+    {
+        direction.held = std::move(packet);
+        direction.heldSince = now;
+        this->reorderedPackets++;
+        return;
+    }
+
+    this->enqueue(packet, direction, now);
+    if (duplicate)
+    {
+        this->enqueue(packet, direction, now);
+        this->duplicatedPackets++;
+    }
+
+    if (direction.held != nullptr)
+    {
+        this->enqueue(std::move(direction.held), direction, now);
+        direction.held = nullptr;
+    }
+}
+
+void LossyLink::enqueue(std::shared_ptr<Packet> packet, Direction &direction, unsigned long now)
+{
+    unsigned long jitter = this->impairments.jitter > 0 ? this->nextRandom() % (this->impairments.jitter + 1) : 0;
+    direction.queue.push_back({std::move(packet), now + this->impairments.latency + jitter});
+
+    this->queuedHighWater = max(this->queuedHighWater, this->outgoing.queue.size() + this->incoming.queue.size());
+}
+
+/**
+ * @return a copy of the packet with one flipped payload byte; the packet itself may be in the send window and must stay intact for a retransmission
+ */
+std::shared_ptr<Packet> LossyLink::corrupt(std::shared_ptr<Packet> &packet)
+{
+    if (packet->getPayloadLength() == 0)
+        return packet;
+
+    size_t size = this->serializeToTxBuffer(packet);
+    size_t position = Packet::getHeaderSize() + this->nextRandom() % packet->getPayloadLength();
+    this->getTxBuffer()[position] ^= (uint8_t)(1 << (this->nextRandom() % 8));
+
+    this->parser.feed(this->getTxBuffer(), size);
+    std::shared_ptr<Packet> corrupted = this->parser.next();
+    if (corrupted == nullptr)
+        return packet;
+
+    this->corruptedPackets++;
+
+    return corrupted;
+}
+
+/**
+ * @brief delivers a held packet without a next packet to swap with once it waited longer than any delay, e.g. the last response before a pause.
+ */
+void LossyLink::releaseHeld(Direction &direction, unsigned long now)
+{
+    if (direction.held == nullptr || now - direction.heldSince < this->impairments.latency + this->impairments.jitter)
+        return;
+
+    this->enqueue(std::move(direction.held), direction, now);
+    direction.held = nullptr;
+}
+
+/**
+ * @return milli seconds until the first packet of the direction is due or its held packet is released; UTIL::NO_DEADLINE if the direction is empty
+ */
+unsigned long LossyLink::getTimeToRelease(Direction &direction, unsigned long now)
+{
+    unsigned long time = UTIL::NO_DEADLINE;
+
+    if (!direction.queue.empty())
+        time = (long)(direction.queue.front().releaseAt - now) > 0 ? direction.queue.front().releaseAt - now : 0;
+
+    if (direction.held != nullptr)
+    {
+        unsigned long held = now - direction.heldSince;
+        unsigned long holdTime = this->impairments.latency + this->impairments.jitter;
+        time = min(time, held < holdTime ? holdTime - held : 0);
+    }
+
+    return time;
+}
+
+void LossyLink::writeDue(unsigned long now)
+{
+    this->releaseHeld(this->outgoing, now);
+
+    while (!this->outgoing.queue.empty() && (long)(now - this->outgoing.queue.front().releaseAt) >= 0)
+    {
+        this->duePackets.push_back(std::move(this->outgoing.queue.front().packet));
+        this->outgoing.queue.pop_front();
+    }
+
+    // the packets that are due together are written as one batch like without the link
+    if (!this->duePackets.empty())
+    {
+        this->protocol->writePackets(this->duePackets);
+        this->duePackets.clear();
+    }
+}
+
+void LossyLink::clear()
+{
+    this->outgoing.queue.clear();
+    this->outgoing.held = nullptr;
+    this->incoming.queue.clear();
+    this->incoming.held = nullptr;
+    this->parser.reset();
+}
+
+bool LossyLink::chance(float probability)
+{
+    // 24 bits are enough for the resolution of a float in [0, 1)
+    return (this->nextRandom() >> 8) < (uint32_t)(probability * (1UL << 24));
+}
+
+/**
+ * @brief xorshift32; small, fast and the same on every platform, unlike random()
+ * @cite https://doi.org/10.18637/jss.v008.i14
+ */
+uint32_t LossyLink::nextRandom()
+{
+    uint32_t x = this->randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    this->randomState = x;
+
+    return x;
+}
@@ -0,0 +1,89 @@
+#ifndef LOSSY_LINK_H
+#define LOSSY_LINK_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "ProtocolBase.h"
+#include "Packet.h"
+#include "Config.h"
+
+//probabilities and delays of the impairments in both directions; the defaults are NET::LOSSY_LINK_*
+struct LossyLinkImpairments {
+    float loss = NET::LOSSY_LINK_LOSS; //probability that a packet is dropped
+    float duplicate = NET::LOSSY_LINK_DUPLICATE; //probability that a packet is delivered twice
+    float reorder = NET::LOSSY_LINK_REORDER; //probability that a packet is delivered after the next one
+    float corrupt = NET::LOSSY_LINK_CORRUPT; //probability that one payload byte is flipped
+    unsigned long latency = NET::LOSSY_LINK_LATENCY; //milli seconds
+    unsigned long jitter = NET::LOSSY_LINK_JITTER; //milli seconds added at random to the latency
+};
+
+struct LossyLinkStatistics {
+    uint32_t seed;
+    unsigned long droppedPackets;
+    unsigned long duplicatedPackets;
+    unsigned long reorderedPackets;
+    unsigned long corruptedPackets;
+    size_t queuedPackets; //delayed packets in both directions
+    size_t queuedHighWater; //highest number of delayed packets at the same time
+};
+
+//decorator for a protocol that impairs the packets in both directions like a bad radio link; the impairments are reproducible with the seed
+class LossyLink : public ProtocolBase {
+    public:
+        LossyLink(uint32_t seed, LossyLinkImpairments impairments = LossyLinkImpairments());
+
+        void setProtocol(ProtocolBase *protocol);
+        void setImpairments(LossyLinkImpairments impairments);
+        void init() override;
+        void destroy() override;
+        void writePacket(std::shared_ptr<Packet> packet) override;
+        void writePackets(std::vector<std::shared_ptr<Packet>> &packets) override;
+        std::shared_ptr<Packet> readPacket() override;
+        bool checkConnection() override;
+        unsigned long getPollInterval() override;
+        size_t getPendingPackets() override;
+        LossyLinkStatistics getStatistics();
+        void getStatistics(JsonObject &json);
+
+    private:
+        struct DelayedPacket {
+            std::shared_ptr<Packet> packet;
+            unsigned long releaseAt;//millis() after which the packet is delivered
+        };
+
+        struct Direction {
+            std::deque<DelayedPacket> queue;
+            std::shared_ptr<Packet> held;//packet that is delivered after the next one
+            unsigned long heldSince;
+        };
+
+        ProtocolBase *protocol;
+        const uint32_t seed;
+        uint32_t randomState;
+        LossyLinkImpairments impairments;
+        Direction outgoing;
+        Direction incoming;
+
+        unsigned long droppedPackets;
+        unsigned long duplicatedPackets;
+        unsigned long reorderedPackets;
+        unsigned long corruptedPackets;
+        size_t queuedHighWater;
+        std::vector<std::shared_ptr<Packet>> duePackets;
+
+        void impair(std::shared_ptr<Packet> packet, Direction &direction, unsigned long now);
+        void enqueue(std::shared_ptr<Packet> packet, Direction &direction, unsigned long now);
+        std::shared_ptr<Packet> corrupt(std::shared_ptr<Packet> &packet);
+        void releaseHeld(Direction &direction, unsigned long now);
+        unsigned long getTimeToRelease(Direction &direction, unsigned long now);
+        void writeDue(unsigned long now);
+        void clear();
+        bool chance(float probability);
+        uint32_t nextRandom();
+};
+
+#endif
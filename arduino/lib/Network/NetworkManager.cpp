@@ -1,7 +1,6 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <vector>
-#include <queue>
 #include <memory>
 
 #include "NetworkManager.h"
@@ -12,7 +11,9 @@
 #include "Packet.h"
 #include "Logger.h"
 #include "PacketRelay.h"
+#include "PacketPool.h"
 #include "Definitions.h"
+#include "TaskSignal.h"
 
 #if WIRELESS_MODE == BLE
 #include "BluetoothProtocol.h"
@@ -20,7 +21,10 @@
 #include "WifiProtocol.h"
 #endif
 
-NetworkManager::NetworkManager(Storage *storage) : currentProtocol(nullptr), lastHeartBeat(0), upgradeProtocolTimeout(0)
+NetworkManager::NetworkManager(Storage *storage) : currentProtocol(nullptr), lastHeartBeat(0), upgradeProtocolTimeout(0), readPending(false), inboundPackets(0), inboundBudgetExhausted(0), inboundHighWater(0), writePending(false), outboundBatches(0), outboundBudgetExhausted(0)
+#if LOSSY_LINK
+    , lossyLink(NET::LOSSY_LINK_SEED)
+#endif
 {
     // init of logging and relay classes; set networkqueue so that we can process it here
     this->logger = Logger::getInstance();
@@ -47,24 +51,62 @@ NetworkManager::NetworkManager(Storage *storage) : currentProtocol(nullptr), las
 
 NetworkManager::~NetworkManager() {}
 
-std::vector<JsonDocument> NetworkManager::readIncomingData()
+/**
+ * @brief reads and processes the received packets until the protocol has no complete packet left or NET::INBOUND_BUDGET_US micro seconds are spent, so that a burst of commands is handled in one iteration instead of one packet per iteration. the packets that are left stay in the protocol and are read in the next iteration, which getTimeToNextEvent schedules at once.
+ * @return the command packets that were read; they are parsed by the commandmanager
+ */
+std::vector<std::shared_ptr<Packet>> NetworkManager::readIncomingData()
 {    
-    std::vector<JsonDocument> output;    
-    std::shared_ptr<Packet> packet = this->currentProtocol->readPacket();    
-    if (packet == nullptr)
-        return output;    
+    std::vector<std::shared_ptr<Packet>> output;    
+    unsigned long startTime = micros();
+    size_t packetCount = 0;
 
-    std::vector<std::shared_ptr<Packet>> result = this->integrityMiddleware.processIncomingData(std::move(packet));    
-    for (std::shared_ptr<Packet> data : result)
+    // stays true if the budget is spent before the protocol ran out of packets
+    this->readPending = true;
+
+    while (micros() - startTime < NET::INBOUND_BUDGET_US)
     {
-        JsonDocument doc;
+        std::shared_ptr<Packet> packet = this->getLink()->readPacket();    
+        if (packet == nullptr)
+        {
+            this->readPending = false;
+            break;
+        }
 
-        DeserializationError error = deserializeJson(doc, data->getPayload().get());        
+        packetCount++;
+        this->readIncomingPacket(std::move(packet), output);
+    }
+
+    if (this->readPending)
+        this->inboundBudgetExhausted++;
+
+    this->inboundPackets += packetCount;
+    this->inboundHighWater = max(this->inboundHighWater, packetCount);
+
+    return output;
+}
+
+//hands the collected packets to the protocol with one call
+void NetworkManager::writeOutgoingBatch()
+{
+    if (this->outgoingBatch.empty())
+        return;
+
+    this->getLink()->writePackets(this->outgoingBatch);
+    this->outgoingBatch.clear();
+    this->outboundBatches++;
+}
+
+//passes one received packet through the integrity middleware and appends the command packets it releases
+void NetworkManager::readIncomingPacket(std::shared_ptr<Packet> packet, std::vector<std::shared_ptr<Packet>> &output)
+{
+    std::vector<std::shared_ptr<Packet>> result = this->integrityMiddleware.processIncomingData(std::move(packet));    
+    for (std::shared_ptr<Packet> &data : result)
+    {
         switch (data->getMethod())
         {
-        case NET::HEADER::METHOD_COMMAND:            
-            output.push_back(doc);
-
+        case NET::HEADER::METHOD_COMMAND:
+            output.push_back(std::move(data));
             break;
         case NET::HEADER::METHOD_HEARTBEAT:
             // this->heartbeatMonitor.registerHeartbeat();
@@ -72,42 +114,102 @@ std::vector<JsonDocument> NetworkManager::readIncomingData()
         default:
             break;
         }
-
-        if (error)
-        {
-
-            this->logger->ferror(prefix("can not deserialise json string: %%"), std::vector<String>{error.c_str()});
-
-            return output;
-        }
     }    
-    return output;
 }
 
+/**
+ * @brief writes the retransmissions and then the output queue in batches of NET::WRITE_BATCH_SIZE packets, so that a stream transport writes several packets with one operation. after each batch the writing stops once NET::OUTBOUND_BUDGET_US micro seconds are spent, so that a backlog can not block the loop; the packets that are left stay in the output queue for the next iteration.
+ */
 void NetworkManager::writeOutgoingData()
 {
-    while (!this->output.empty())
+    this->writeOutput(false);
+}
+
+/**
+ * @brief writes the whole output queue without a time budget, e.g. before the framing or the header format changes, so that every queued packet leaves in the format it was queued for. a packet whose slot in the send window is still taken is written without being kept for a retransmission instead of waiting for an ACK.
+ */
+void NetworkManager::flushOutput()
+{
+    // a log that is queued while the queue is written may land in a class that was already written
+    do
     {
-        std::shared_ptr<Packet> nextPacket = this->output.front();
-        this->output.pop();
+        this->writeOutput(true);
+    } while (!this->output.empty());
+}
 
-        std::shared_ptr<Packet> notedPacket = this->integrityMiddleware.processOutgoingData(std::move(nextPacket));
+/**
+ * @param flush ignores NET::OUTBOUND_BUDGET_US and writes the packets that canSend holds back, see flushOutput
+ */
+void NetworkManager::writeOutput(bool flush)
+{
+    unsigned long startTime = micros();
+
+    this->writePending = false;
+
+    // a delayed ACK whose delay is over is queued before the output is written
+    this->integrityMiddleware.flushAcknowledgement();
+
+    // packets from the send window whose ACK is overdue go first; they are already noted by the integrity middleware
+    this->integrityMiddleware.collectRetransmissions(this->outgoingBatch);
 
-        if (notedPacket != nullptr)
+    // the classes are written with strict priority, so a response never waits behind the data backlog
+    for (uint8_t i = 0; i < OutputQueue::CLASS_COUNT; i++)
+    {
+        OutputQueue::Class outputClass = (OutputQueue::Class)i;
+
+        std::shared_ptr<Packet> nextPacket;
+        while ((nextPacket = this->output.front(outputClass)) != nullptr)
         {
-            this->currentProtocol->writePacket(std::move(notedPacket));
+            // the packet stays in its queue while its slot in the send window is taken, so that the order within the class is kept; the classes behind it may still be written
+            bool keep = this->integrityMiddleware.canSend(nextPacket);
+            if (!keep && !flush)
+                break;
+
+            if (this->outgoingBatch.size() >= NET::WRITE_BATCH_SIZE)
+            {
+                this->writeOutgoingBatch();
+
+                // the rest of the queue is written in the next iteration, which getTimeToNextEvent schedules at once
+                if (!flush && micros() - startTime >= NET::OUTBOUND_BUDGET_US)
+                {
+                    this->writePending = true;
+                    this->outboundBudgetExhausted++;
+
+                    return;
+                }
+            }
+
+            this->output.pop(outputClass, nextPacket);
+
+            std::shared_ptr<Packet> notedPacket = this->integrityMiddleware.processOutgoingData(std::move(nextPacket), keep);
+
+            if (notedPacket != nullptr)
+            {
+                this->outgoingBatch.push_back(std::move(notedPacket));
+            }
         }
     }
+
+    this->writeOutgoingBatch();
 }
 
 void NetworkManager::addSensorDataToOutput(std::vector<std::shared_ptr<Packet>> &sensorData)
 {
-    for (std::shared_ptr<Packet> item : sensorData)
+    for (std::shared_ptr<Packet> &item : sensorData)
     {
-        this->output.push(item);
+        this->output.push(std::move(item));
     }
 }
 
+/**
+ * @brief number of data packets that may be added to the output now without dropping older ones. the data class of the output queue holds NET::OUTPUT_QUEUE_CAPACITY packets; sensor data is BEST_EFFORT and does not occupy the send window. responses and logs are not limited by this value.
+ * @return capacity for new data packets
+ */
+size_t NetworkManager::getSendCapacity()
+{
+    return this->output.getRoom(OutputQueue::CLASS_DATA);
+}
+
 bool NetworkManager::isConnected()
 {
     return this->currentProtocol->checkConnection();
@@ -148,6 +250,42 @@ void NetworkManager::sendHeartbeatToClient()
         this->relay->heartbeat();
 }
 
+/**
+ * @brief sets the signal that wakes the task of the networkmanager when a protocol received data or a packet was added to the output queue
+ */
+void NetworkManager::setSignal(TaskSignal *signal)
+{
+    this->serialProtocol->setDataSignal(signal);
+#if WIRELESS_MODE == BLE
+    this->bluetoothProtocol->setDataSignal(signal);
+#elif WIRELESS_MODE == WIFI
+    this->wifiProtocol->setDataSignal(signal);
+#endif
+    this->output.setSignal(signal);
+}
+
+/**
+ * @brief tells the main loop how long it may sleep. received data and new packets in the output queue wake it through the signal (see setSignal), everything else has a deadline: the protocol upgrade, the heartbeat, the delayed ACK, the next retransmission and the poll interval of a protocol that can not signal received data.
+ * @return milli seconds until the networkmanager has work that is not signalled; 0 if the last read or write stopped at its budget
+ */
+unsigned long NetworkManager::getTimeToNextEvent()
+{
+    if (this->readPending || this->writePending)
+        return 0;
+
+    unsigned long now = millis();
+    unsigned long time = this->getTimeToTimeout(this->upgradeProtocolTimeout, NET::TIMEOUT_WIRELESS_UPGRADE, now);
+
+    if (this->isConnected())
+    {
+        time = min(time, this->getTimeToTimeout(this->lastHeartBeat, NET::HEARTBEAT_INTERVAL, now));
+        time = min(time, this->integrityMiddleware.getTimeToNextEvent(now));
+        time = min(time, this->getLink()->getPollInterval());
+    }
+
+    return time;
+}
+
 bool NetworkManager::checkTimeout(unsigned long &lastTimeout, unsigned long interval)
 {
     unsigned long now = millis();
@@ -161,12 +299,46 @@ bool NetworkManager::checkTimeout(unsigned long &lastTimeout, unsigned long inte
     return false;
 }
 
+//milli seconds until checkTimeout returns true for the same arguments
+unsigned long NetworkManager::getTimeToTimeout(unsigned long lastTimeout, unsigned long interval, unsigned long now)
+{
+    unsigned long elapsed = now - lastTimeout;
+
+    return elapsed >= interval ? 0 : interval - elapsed;
+}
+
 void NetworkManager::readConnection()
 {
     JsonDocument doc;
     doc["name"] = CMD::CONNECTION_READ;
     doc["protocol"] = this->currentProtocol->getName();
     doc["connection"] = this->currentProtocol->checkConnection();
+    doc["serial_framing"] = this->serialProtocol->getFraming();
+    doc["sequence"] = Packet::isExtendedSequence() ? NET::SEQUENCE_EXTENDED : NET::SEQUENCE_SHORT;
+
+    JsonObject inbound = doc["inbound"].to<JsonObject>();
+    inbound["budget_us"] = NET::INBOUND_BUDGET_US;
+    inbound["pending"] = this->getLink()->getPendingPackets();
+    inbound["packets"] = this->inboundPackets;
+    inbound["budget_exhausted"] = this->inboundBudgetExhausted;
+    inbound["high_water"] = this->inboundHighWater;
+
+    JsonObject outbound = doc["outbound"].to<JsonObject>();
+    outbound["budget_us"] = NET::OUTBOUND_BUDGET_US;
+    outbound["batch_size"] = NET::WRITE_BATCH_SIZE;
+    outbound["batches"] = this->outboundBatches;
+    outbound["budget_exhausted"] = this->outboundBudgetExhausted;
+
+    JsonObject packetPool = doc["packet_pool"].to<JsonObject>();
+    PacketPool::getInstance()->getStatistics(packetPool);
+    JsonObject outputQueue = doc["output_queue"].to<JsonObject>();
+    this->output.getStatistics(outputQueue);
+    JsonObject sendWindow = doc["send_window"].to<JsonObject>();
+    this->integrityMiddleware.getSendWindowStatistics(sendWindow);
+#if LOSSY_LINK
+    JsonObject lossyLink = doc["lossy_link"].to<JsonObject>();
+    this->lossyLink.getStatistics(lossyLink);
+#endif
 
     this->sendJsonDocument(doc);
 }
@@ -341,6 +513,77 @@ void NetworkManager::disableAckPackets()
     this->sendJsonDocument(doc);
 }
 
+/**
+ * @brief switches the framing of the serial protocol. packets that are already in the output queue are written with the old framing first (see flushOutput, which ignores the time budget and the send window), so that the response to this command is the first packet in the new framing and the client knows where to switch.
+ * @param json contains the key framing with NET::FRAMING_RAW or NET::FRAMING_COBS
+ */
+void NetworkManager::selectSerialFraming(JsonDocument *json)
+{
+    String framing = (*json)["framing"].as<String>();
+
+    this->flushOutput();
+    bool success = this->serialProtocol->setFraming(framing);
+
+    JsonDocument doc;
+    doc["name"] = CMD::SERIAL_FRAMING_SELECT;
+    doc["framing"] = this->serialProtocol->getFraming();
+    doc["success"] = success;
+    if (!success)
+    {
+        doc["error"] = "framing must be raw or cobs";
+    }
+
+    this->sendJsonDocument(doc);
+}
+
+/**
+ * @brief switches between the 16 bit sequence and the 32 bit sequence for all protocols. like selectSerialFraming, all packets in the output queue are flushed in the old mode first, without the time budget of writeOutgoingData, and the response is the first packet in the new mode; the client must not send packets in the new mode before it received the response.
+ * @param json contains the key sequence with NET::SEQUENCE_SHORT or NET::SEQUENCE_EXTENDED
+ */
+void NetworkManager::selectSequenceMode(JsonDocument *json)
+{
+    String mode = (*json)["sequence"].as<String>();
+    bool success = mode == NET::SEQUENCE_SHORT || mode == NET::SEQUENCE_EXTENDED;
+
+    if (success)
+    {
+        this->flushOutput();
+        Packet::setExtendedSequence(mode == NET::SEQUENCE_EXTENDED);
+    }
+
+    JsonDocument doc;
+    doc["name"] = CMD::SEQUENCE_MODE_SELECT;
+    doc["sequence"] = Packet::isExtendedSequence() ? NET::SEQUENCE_EXTENDED : NET::SEQUENCE_SHORT;
+    doc["success"] = success;
+    if (!success)
+    {
+        doc["error"] = "sequence must be short or extended";
+    }
+
+    this->sendJsonDocument(doc);
+}
+
+/**
+ * @brief called by the devicemanager when a record is created with the key fec_group
+ */
+void NetworkManager::setForwardErrorCorrection(uint8_t groupSize)
+{
+    this->integrityMiddleware.setForwardErrorCorrection(groupSize);
+}
+
+/**
+ * @return the protocol that packets are read from and written to: the current protocol, or the LossyLink around it in builds with LOSSY_LINK=1
+ */
+ProtocolBase* NetworkManager::getLink()
+{
+#if LOSSY_LINK
+    this->lossyLink.setProtocol(this->currentProtocol);
+    return &(this->lossyLink);
+#else
+    return this->currentProtocol;
+#endif
+}
+
 void NetworkManager::sendJsonDocument(JsonDocument &doc)
 {
     size_t bufferSize = measureJson(doc) + 1;
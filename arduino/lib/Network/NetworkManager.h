@@ -1,7 +1,6 @@
 #ifndef NETWORK_MANAGER_H
 #define NETWORK_MANAGER_H
 
-#include <queue>
 #include <vector>
 #include <Arduino.h>
 #include <ArduinoJson.h>
@@ -13,9 +12,16 @@
 #include "SerialProtocol.h"
 #include "Packet.h"
 #include "PacketRelay.h"
+#include "OutputQueue.h"
 #include "IntegrityMiddleware.h"
+#include "Capabilities.h"
+#include "TaskSignal.h"
 #include "Definitions.h"
 
+#if LOSSY_LINK
+#include "LossyLink.h"
+#endif
+
 #if WIRELESS_MODE == BLE
 #include "BluetoothProtocol.h"
 #elif WIRELESS_MODE == WIFI
@@ -23,17 +29,21 @@
 #include "WifiProfile.h"
 #endif
 
-class NetworkManager {
+class NetworkManager: public INetworkCapabilities {
     public:
         NetworkManager(Storage *storage);
         ~NetworkManager();
 
         /* regular functions */
-        std::vector<JsonDocument> readIncomingData();//put that data into input and inform the commandmanager
+        std::vector<std::shared_ptr<Packet>> readIncomingData();//command packets that the commandmanager parses and executes
         void writeOutgoingData();//write data in output queue to network;
+        void flushOutput();
         void addSensorDataToOutput(std::vector<std::shared_ptr<Packet>> &sensorData);
+        size_t getSendCapacity();
         bool isConnected();
         void upgradeProtocol();
+        void setSignal(TaskSignal *signal);
+        unsigned long getTimeToNextEvent();
 
         /* command functions*/        
         
@@ -51,10 +61,17 @@ class NetworkManager {
         void readConnection();
         void enableAckPackets();
         void disableAckPackets();
+        void selectSerialFraming(JsonDocument *json);
+        void selectSequenceMode(JsonDocument *json);
+        void setForwardErrorCorrection(uint8_t groupSize) override;
 
     private:
         unsigned long lastHeartBeat;
         unsigned long upgradeProtocolTimeout;
+        bool readPending;//the last read returned a packet, so the next one may already wait in the protocol
+        unsigned long inboundPackets;
+        unsigned long inboundBudgetExhausted;//iterations that stopped reading because the budget was spent
+        size_t inboundHighWater;//most packets read in one iteration
 
         ProtocolBase *currentProtocol;
         #if WIRELESS_MODE == BLE
@@ -64,13 +81,25 @@ class NetworkManager {
         WifiProtocol *wifiProtocol;
         #endif
         SerialProtocol *serialProtocol;
+        #if LOSSY_LINK
+        LossyLink lossyLink;
+        #endif
         IntegrityMiddleware integrityMiddleware;
         Logger *logger;
         PacketRelay *relay;
-        std::queue<std::shared_ptr<Packet>> output;
+        OutputQueue output;
+        std::vector<std::shared_ptr<Packet>> outgoingBatch;//packets that are written with the next writePackets call
+        bool writePending;//the last write stopped at the budget with packets left in the output queue
+        unsigned long outboundBatches;
+        unsigned long outboundBudgetExhausted;//iterations that stopped writing because the budget was spent
 
+        ProtocolBase* getLink();
+        void readIncomingPacket(std::shared_ptr<Packet> packet, std::vector<std::shared_ptr<Packet>> &output);
+        void writeOutgoingBatch();
+        void writeOutput(bool flush);
         void sendJsonDocument(JsonDocument& doc);
         bool checkTimeout(unsigned long &lastTimeout, unsigned long interval);
+        unsigned long getTimeToTimeout(unsigned long lastTimeout, unsigned long interval, unsigned long now);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <memory>
+#include <mutex>
+
+#include "OutputQueue.h"
+#include "Packet.h"
+#include "Config.h"
+#include "TaskSignal.h"
+
+/**
+ * @class OutputQueue
+ * @file OutputQueue.cpp
+ * @brief Replaces the single unbounded queue that the NetworkManager, Logger and PacketRelay shared, where a response to RECORD_STOP could wait behind every data packet of the record.
+ *
+ * Every packet is put into the queue of its class (see classify) and the NetworkManager writes the classes in the order of the enum, so control packets and responses only wait for the packet that is being written, no matter how many data packets are queued. Each class is a fixed ring with its own capacity from Config.h, so the memory of the queue is bounded. When a class is full, its drop policy either drops the new packet (responses and errors keep the order of the ones already queued) or the oldest one (ACKs, heartbeats, data and debug logs, where the newer packet is worth more). The order within a class is kept.
+ * The queue is locked because the sampling task adds logs and responses while the network task writes the packets (see main.cpp).
+ */
+OutputQueue::OutputQueue() : signal(nullptr)
+{
+    this->initLane(CLASS_CONTROL, NET::OUTPUT_QUEUE_CONTROL_CAPACITY, NET::QueueDropPolicy::DROP_OLDEST);
+    this->initLane(CLASS_RESPONSE, NET::OUTPUT_QUEUE_RESPONSE_CAPACITY, NET::QueueDropPolicy::DROP_NEWEST);
+    this->initLane(CLASS_ERROR, NET::OUTPUT_QUEUE_ERROR_CAPACITY, NET::QueueDropPolicy::DROP_NEWEST);
+    this->initLane(CLASS_DATA, NET::OUTPUT_QUEUE_CAPACITY, NET::QueueDropPolicy::DROP_OLDEST);
+    this->initLane(CLASS_DEBUG, NET::OUTPUT_QUEUE_DEBUG_CAPACITY, NET::QueueDropPolicy::DROP_OLDEST);
+}
+
+void OutputQueue::setSignal(TaskSignal *signal)
+{
+    this->signal = signal;
+}
+
+/**
+ * @brief adds the packet to the queue of its class and applies the drop policy of the class if it is full.
+ * @return false if the packet itself was dropped
+ */
+bool OutputQueue::push(std::shared_ptr<Packet> packet)
+{
+    if (packet == nullptr)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        Lane &lane = this->lanes[OutputQueue::classify(packet->getMethod())];
+
+        if (lane.count == lane.capacity)
+        {
+            lane.droppedPackets++;
+
+            if (lane.policy == NET::QueueDropPolicy::DROP_NEWEST)
+                return false;
+
+            // drop the oldest packet; its slot becomes the slot of the newest one
+            this->popOldest(lane);
+        }
+
+        lane.slots[(lane.head + lane.count) % lane.capacity] = std::move(packet);
+        lane.count++;
+        lane.highWater = max(lane.highWater, lane.count);
+    }
+
+    if (this->signal != nullptr)
+        this->signal->notify();
+
+    return true;
+}
+
+/**
+ * @return the oldest packet of the class or nullptr if the class is empty
+ */
+std::shared_ptr<Packet> OutputQueue::front(Class outputClass)
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    Lane &lane = this->lanes[outputClass];
+
+    return lane.count > 0 ? lane.slots[lane.head] : nullptr;
+}
+
+/**
+ * @brief removes the packet that front returned. another task may have dropped it in the meantime because its class was full; then nothing is removed.
+ */
+void OutputQueue::pop(Class outputClass, const std::shared_ptr<Packet> &packet)
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    Lane &lane = this->lanes[outputClass];
+
+    if (lane.count > 0 && lane.slots[lane.head] == packet)
+        this->popOldest(lane);
+}
+
+bool OutputQueue::empty(Class outputClass)
+{
+    return this->size(outputClass) == 0;
+}
+
+bool OutputQueue::empty()
+{
+    return this->size() == 0;
+}
+
+size_t OutputQueue::size(Class outputClass)
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    return this->lanes[outputClass].count;
+}
+
+size_t OutputQueue::size()
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    size_t count = 0;
+    for (uint8_t i = 0; i < CLASS_COUNT; i++)
+    {
+        count += this->lanes[i].count;
+    }
+
+    return count;
+}
+
+/**
+ * @return packets that can be added to the class before its drop policy applies
+ */
+size_t OutputQueue::getRoom(Class outputClass)
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    Lane &lane = this->lanes[outputClass];
+
+    return lane.capacity - lane.count;
+}
+
+void OutputQueue::clear()
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    for (uint8_t i = 0; i < CLASS_COUNT; i++)
+    {
+        while (this->lanes[i].count > 0)
+        {
+            this->popOldest(this->lanes[i]);
+        }
+    }
+}
+
+void OutputQueue::getStatistics(JsonObject &json)
+{
+    static const char *names[CLASS_COUNT] = {"control", "response", "error", "data", "debug"};
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    for (uint8_t i = 0; i < CLASS_COUNT; i++)
+    {
+        JsonObject lane = json[names[i]].to<JsonObject>();
+        lane["capacity"] = this->lanes[i].capacity;
+        lane["queued"] = this->lanes[i].count;
+        lane["high_water"] = this->lanes[i].highWater;
+        lane["dropped"] = this->lanes[i].droppedPackets;
+    }
+}
+
+/**
+ * @return the class of the packet by its method; parity packets belong to the data they protect
+ */
+OutputQueue::Class OutputQueue::classify(uint8_t method)
+{
+    switch (method)
+    {
+    case NET::HEADER::METHOD_ACKNOWLEDGEMENT:
+    case NET::HEADER::METHOD_HEARTBEAT:
+        return CLASS_CONTROL;
+    case NET::HEADER::METHOD_ERROR:
+        return CLASS_ERROR;
+    case NET::HEADER::METHOD_DATA:
+    case NET::HEADER::METHOD_BATCH:
+    case NET::HEADER::METHOD_PARITY:
+        return CLASS_DATA;
+    case NET::HEADER::METHOD_DEBUG:
+        return CLASS_DEBUG;
+    default:
+        return CLASS_RESPONSE;
+    }
+}
+
+void OutputQueue::popOldest(Lane &lane)
+{
+    lane.slots[lane.head] = nullptr;
+    lane.head = (lane.head + 1) % lane.capacity;
+    lane.count--;
+}
+
+void OutputQueue::initLane(Class outputClass, size_t capacity, NET::QueueDropPolicy policy)
+{
+    Lane &lane = this->lanes[outputClass];
+    lane.slots.reset(new std::shared_ptr<Packet>[capacity]);
+    lane.capacity = capacity;
+    lane.head = 0;
+    lane.count = 0;
+    lane.policy = policy;
+    lane.droppedPackets = 0;
+    lane.highWater = 0;
+}
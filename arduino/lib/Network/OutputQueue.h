@@ -0,0 +1,62 @@
+#ifndef OUTPUT_QUEUE_H
+#define OUTPUT_QUEUE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <memory>
+#include <mutex>
+
+#include "Packet.h"
+#include "Config.h"
+#include "TaskSignal.h"
+
+//packets that wait to be written to the network, in one bounded queue per class; the classes are drained with strict priority
+class OutputQueue {
+    public:
+        //ordered by priority; CLASS_CONTROL is written first
+        enum Class : uint8_t {
+            CLASS_CONTROL,
+            CLASS_RESPONSE,
+            CLASS_ERROR,
+            CLASS_DATA,
+            CLASS_DEBUG,
+            CLASS_COUNT
+        };
+
+        OutputQueue();
+
+        void setSignal(TaskSignal *signal);
+        bool push(std::shared_ptr<Packet> packet);
+        std::shared_ptr<Packet> front(Class outputClass);
+        void pop(Class outputClass, const std::shared_ptr<Packet> &packet);
+        bool empty(Class outputClass);
+        bool empty();
+        size_t size(Class outputClass);
+        size_t size();
+        size_t getRoom(Class outputClass);
+        void clear();
+        void getStatistics(JsonObject &json);
+
+        static Class classify(uint8_t method);
+
+    private:
+        //fixed ring of packets
+        struct Lane {
+            std::unique_ptr<std::shared_ptr<Packet>[]> slots;
+            size_t capacity;
+            size_t head;//index of the oldest packet
+            size_t count;
+            NET::QueueDropPolicy policy;
+            unsigned long droppedPackets;
+            size_t highWater;
+        };
+
+        Lane lanes[CLASS_COUNT];
+        std::mutex lock;
+        TaskSignal *signal;//notified when a packet was added, so that the task that writes the packets wakes up
+
+        void popOldest(Lane &lane);
+        void initLane(Class outputClass, size_t capacity, NET::QueueDropPolicy policy);
+};
+
+#endif
@@ -1,9 +1,8 @@
 #include <Arduino.h>
-#include <CRC8.h>
-#include <CRC.h>
 #include <memory>
 
 #include "Packet.h"
+#include "Checksum.h"
 #include "Config.h"
 #include "Logger.h"
 
@@ -13,34 +12,51 @@
  * @brief A class for creating, serialising, deserialising network packets for the mayako framework.
  *
  * This is a binary protocol, so do use implementation such as Serial.write() to transfer data.
- * we must pay special attention to the caluclation of the payloadsize because cpp uses strings with an extra terminating character (\0) while python does not. this is why we subtract 1 from the payloadsize in the serialize method and also calculate the checksum with the length subtracted by 1 so that client and this device produce the same output.
+ * we must pay special attention to the caluclation of the payloadsize because cpp uses strings with an extra terminating character (\0) while python does not. this is why we subtract 1 from the payloadsize in the serialize method (the \0 is never written to the network) and also calculate the checksum with the length subtracted by 1 so that client and this device produce the same output.
  *
  * @code for outgoing data
  * Packet packet;
  * packet.setMethod(NET::HEADER::METHOD_DATA); //defined in Config.h
  * packet.setSequence(42);
  * packet.setPayload("Hello, world!");
- * char* buffer = packet.serialize();
+ * uint8_t buffer[NET::MAX_BUFFER_SIZE];
+ * size_t length = packet.serialize(buffer, sizeof(buffer));
  *
- * => Send buffer over the network...
+ * => Send length bytes of buffer over the network...
  *
  * @code for incoming data
  * Packet packet;
  * if (packet.deserializeHeader(buffer) && packet.deserializePayload(buffer)) {
  *      //use data and header elements with getter functions
  *      packet.getMethod();
- *      packet.getPayload();
+ *      packet.getPayloadView();
  * }
  *
  * @cite https://mfreiholz.de/posts/network-protocol-parser/
- * @cite https://github.com/RobTillaart/CRC
  *
  */
-Packet::Packet() : method(NET::HEADER::METHOD_ACKNOWLEDGEMENT), sequence(0), checksum(0), payloadSize(0), payload(nullptr), headerSize(NET::HEADER::SIZE), nodeIdentity(0) {}
+bool Packet::extendedSequence = NET::DEFAULT_SEQUENCE_MODE == NET::SEQUENCE_EXTENDED;
 
+Packet::Packet() : method(NET::HEADER::METHOD_ACKNOWLEDGEMENT), sequence(0), checksum(0), payloadSize(0), payload(nullptr), nodeIdentity(0), deliveryClass(NET::DeliveryClass::BEST_EFFORT), stream(0) {}
+
+/**
+ * @brief sets the method and the default delivery class of the method; call setDeliveryClass afterwards to change it.
+ */
 void Packet::setMethod(uint8_t method)
 {
     this->method = method;
+    this->deliveryClass = Packet::defaultDeliveryClass(method);
+    this->stream = 0;
+}
+
+/**
+ * @brief overrides how the integrity layer treats this packet when ACK packets are enabled.
+ * @param stream identifies the state that a LATEST_VALUE packet belongs to, e.g. one sensor; ignored for the other classes
+ */
+void Packet::setDeliveryClass(NET::DeliveryClass deliveryClass, uint32_t stream)
+{
+    this->deliveryClass = deliveryClass;
+    this->stream = stream;
 }
 
 void Packet::setNodeIdentity(const char *nodeIdentity)
@@ -55,7 +71,10 @@ void Packet::setNodeIdentity(const char *nodeIdentity)
     this->nodeIdentity |= nodeIdentity[3] << 0;
 }
 
-void Packet::setSequence(uint16_t sequence)
+/**
+ * @param sequence the full 32 bit sequence; in the short sequence mode only the lower 16 bits are written to the network
+ */
+void Packet::setSequence(uint32_t sequence)
 {
     this->sequence = sequence;
 }
@@ -72,9 +91,19 @@ void Packet::setPayloadSize(uint16_t payloadSize)
 
 void Packet::setPayload(const char *payload)
 {
-    this->payloadSize = strlen(payload) + 1;
-    this->payload = std::unique_ptr<char[]>(new char[payloadSize]);
-    strncpy(this->payload.get(), payload, this->payloadSize); // as char* payload already has a \0 to determine that end of the char array, we dont need to add another \0
+    this->setPayload((const uint8_t *)payload, strlen(payload));
+}
+
+/**
+ * @brief sets a payload that may contain \0 bytes, e.g. binary encoded sensor data. the payload is still stored with a terminating \0 so that payloadSize keeps the same meaning as for json payloads.
+ * @param payload bytes of the payload
+ * @param length number of bytes in payload without any terminating \0
+ */
+void Packet::setPayload(const uint8_t *payload, size_t length)
+{
+    this->payloadSize = length + 1;
+    this->payload = std::unique_ptr<char[], PacketPayloadDeleter>(PacketPool::getInstance()->allocatePayload(this->payloadSize));
+    memcpy(this->payload.get(), payload, length);
     this->payload[this->payloadSize - 1] = '\0';
     this->checksum = this->calculateChecksum(this->payload.get(), this->payloadSize);
 }
@@ -96,11 +125,23 @@ std::unique_ptr<char[]> Packet::getNodeIdentity()
     return name;
 }
 
+/**
+ * @brief the lower 16 bits of the sequence as in the header. the send window and the reorder buffer are much smaller than 2^15 packets, so they compare these with serial number arithmetic in both sequence modes.
+ * @return sequence modulo 2^16
+ */
 uint16_t Packet::getSequence()
 {
     return this->sequence;
 }
 
+/**
+ * @return the 32 bit sequence; the upper 16 bits are 0 for received packets in the short sequence mode
+ */
+uint32_t Packet::getExtendedSequence()
+{
+    return this->sequence;
+}
+
 uint8_t Packet::getChecksum()
 {
     return this->checksum;
@@ -128,12 +169,40 @@ std::unique_ptr<char[]> Packet::getPayload()
 }
 
 /**
- * @brief header size is fixed at 9bytes
+ * @brief borrowed read-only view of the payload without copying it. the pointer is only valid as long as the packet exists and its payload is not replaced. the payload is terminated by \0 but may contain \0 bytes if it is binary, therefore use getPayloadLength.
+ * @return pointer to the payload stored in the packet
+ */
+const char* Packet::getPayloadView()
+{
+    return this->payload.get();
+}
+
+/**
+ * @brief number of bytes in the payload without the terminating \0 character; this is the size that is written to the network.
+ * @return payload length
+ */
+size_t Packet::getPayloadLength()
+{
+    return this->payloadSize > 0 ? this->payloadSize - 1 : 0;
+}
+
+NET::DeliveryClass Packet::getDeliveryClass()
+{
+    return this->deliveryClass;
+}
+
+uint32_t Packet::getStream()
+{
+    return this->stream;
+}
+
+/**
+ * @brief header size is NET::HEADER::SIZE or NET::HEADER::EXTENDED_SIZE in the extended sequence mode
  * @return header size
  */
 size_t Packet::getHeaderSize()
 {
-    return this->headerSize;
+    return Packet::extendedSequence ? NET::HEADER::EXTENDED_SIZE : NET::HEADER::SIZE;
 }
 
 /**
@@ -146,13 +215,28 @@ size_t Packet::getPacketSize()
 }
 
 /**
- * @brief Serialise the properties method, nodeIdentity, sequence, checksum, payloadSize and payload to a header and a payload char array. There is no check if the properties are all set. Properties which take more than 1 byte of memory are translated to big endian because this is the standard format on the network and best practice. The packet is starts with one of the method flags defined in Config.h and terminated by a \0 byte. Use a method to transfer binary data.
- * @return buffer with 9 bytes prefixed header and variable sized payload.
+ * @brief number of bytes that serialize() writes to the network: the header and the payload without the terminating \0 character.
+ * @return size of the serialised packet
  */
-uint8_t* Packet::serialize()
+size_t Packet::getSerializedSize()
 {
-    this->packetSize = this->headerSize + this->payloadSize;
-    auto buffer = new uint8_t[this->packetSize];
+    return Packet::getHeaderSize() + this->payloadSize - 1;
+}
+
+/**
+ * @brief Serialise the properties method, nodeIdentity, sequence, checksum, payloadSize and payload into a buffer owned by the caller. There is no check if the properties are all set. Properties which take more than 1 byte of memory are translated to big endian because this is the standard format on the network and best practice. The packet is starts with one of the method flags defined in Config.h. The terminating \0 of the payload is not written because the client does not expect it. Use a method to transfer binary data.
+ * @param buffer caller owned memory, e.g. the tx buffer of a protocol; nothing is allocated here
+ * @param bufferSize capacity of buffer in bytes
+ * @return number of bytes written to buffer (see getSerializedSize) or 0 if the buffer is too small
+ */
+size_t Packet::serialize(uint8_t *buffer, size_t bufferSize)
+{
+    size_t headerSize = Packet::getHeaderSize();
+    this->packetSize = headerSize + this->payloadSize;
+    size_t serializedSize = this->getSerializedSize();
+
+    if (buffer == nullptr || bufferSize < serializedSize)
+        return 0;
 
     /* in the network environment data is sent in big endian format per convention, although our client "knows" that we do not. we already stored values with more than 8 bit in big endian, therefore we do not require the following conversions any more. */
     // uint16_t bigEndianSequence = __htons(this->sequence);
@@ -172,20 +256,17 @@ uint8_t* Packet::serialize()
     buffer[8] = payloadSizeCache >> 8;
     buffer[9] = payloadSizeCache >> 0;
 
-    /*
-    personal notes:
-    copy a specified number of bytes from one to another memory address.
-    arguments:
-        destination: pointer to the destination memory address; it must be num sized; can use any type
-        source: a pointer to the source memory address; the source memory will not be modified; can use any type
-        num: the number of bytes to copy from source to destination; uses datatype size_t
-
-    we add this->headersize to the buffer address to ensure that the initial 9 bytes - which are the already allocated bytes for the header - are not overwritten.
-    */
+    //the extension keeps the layout of the short header so that the parser always finds the payload size at the same position
+    if (Packet::extendedSequence)
+    {
+        buffer[NET::HEADER::SEQUENCE_HIGH_POSITION] = this->sequence >> 24;
+        buffer[NET::HEADER::SEQUENCE_HIGH_POSITION + 1] = this->sequence >> 16;
+    }
 
-    memcpy(buffer + this->headerSize, this->payload.get(), this->payloadSize);
+    //we add headerSize to the buffer address to ensure that the initial bytes - which are the already written bytes of the header - are not overwritten.
+    memcpy(buffer + headerSize, this->payload.get(), payloadSizeCache);
 
-    return buffer;
+    return serializedSize;
 }
 
 /**
@@ -205,11 +286,16 @@ bool Packet::deserializeHeader(uint8_t *headerBuffer)
     this->sequence = 0;
     this->sequence |= headerBuffer[5] << 8;
     this->sequence |= headerBuffer[6] << 0;
+    if (Packet::extendedSequence)
+    {
+        this->sequence |= (uint32_t)headerBuffer[NET::HEADER::SEQUENCE_HIGH_POSITION] << 24;
+        this->sequence |= (uint32_t)headerBuffer[NET::HEADER::SEQUENCE_HIGH_POSITION + 1] << 16;
+    }
     // this->sequence = __ntohs(this->sequence);
     this->checksum = headerBuffer[7];
     this->payloadSize |= headerBuffer[8] << 8;
     this->payloadSize |= headerBuffer[9] << 0;
-    this->packetSize = this->payloadSize + NET::HEADER::SIZE;
+    this->packetSize = this->payloadSize + Packet::getHeaderSize();
 
     return true;
 }
@@ -217,7 +303,7 @@ bool Packet::deserializeHeader(uint8_t *headerBuffer)
 bool Packet::deserializePayload(char *payloadBuffer)
 {
     this->payloadSize = strlen(payloadBuffer) + 1; // add one for \0 terminator because strlen is implemented to count until (and stop before)
-    this->payload = std::unique_ptr<char[]>(new char[this->payloadSize]);
+    this->payload = std::unique_ptr<char[], PacketPayloadDeleter>(PacketPool::getInstance()->allocatePayload(this->payloadSize));
     strncpy(this->payload.get(), payloadBuffer, this->payloadSize - 1); // as char* payload already has a \0 to determine that end of the char array, we dont need to add another \0
                                                                         //  Add the null terminator
     this->payload[this->payloadSize - 1] = '\0';
@@ -226,11 +312,25 @@ bool Packet::deserializePayload(char *payloadBuffer)
 }
 
 /**
- * @brief calculates the checksum using CRC8-bluetooth parameters
+ * @brief binary safe version of deserializePayload for payloads that are received in chunks (see PacketParser). the checksum of the header is kept so that verifyGoodPacket can compare it with the payload.
+ * @param payloadBuffer bytes of the payload as received from the network, not terminated by \0
+ * @param length number of bytes in payloadBuffer
+ */
+bool Packet::deserializePayload(const uint8_t *payloadBuffer, size_t length)
+{
+    this->payloadSize = length + 1;
+    this->payload = std::unique_ptr<char[], PacketPayloadDeleter>(PacketPool::getInstance()->allocatePayload(this->payloadSize));
+    memcpy(this->payload.get(), payloadBuffer, length);
+    this->payload[this->payloadSize - 1] = '\0';
+
+    return true;
+}
+
+/**
+ * @brief calculates the checksum using CRC8-bluetooth parameters with the lookup table in Checksum.cpp
  * 
  * the payload must be calculated without the \0 character so that calculating it on the client side with python comes to the same result as python uses no \0. therefore we subtract 1 from the lenght of the payload ot be calculated.
  * 
- * @cite https://github.com/RobTillaart/CRC
  * @cite https://crccalc.com
  * @param payload the data attached after the header terminated with a \\0 character.
  * @param length size of payload
@@ -238,7 +338,7 @@ bool Packet::deserializePayload(char *payloadBuffer)
  */
 uint8_t Packet::calculateChecksum(char *payload, size_t length)
 {
-    return calcCRC8((uint8_t *)payload, length - 1, 0xa7, 0x00, 0x00, true, true);
+    return Checksum::crc8((uint8_t *)payload, length - 1);
 }
 
 /**
@@ -267,12 +367,45 @@ bool Packet::verifyFlag(char flag)
     case NET::HEADER::METHOD_HEARTBEAT:
     case NET::HEADER::METHOD_INFO:
     case NET::HEADER::METHOD_ERROR:
+    case NET::HEADER::METHOD_BATCH:
+    case NET::HEADER::METHOD_PARITY:
         return true;
     default:
         return false;
     }
 }
 
+/**
+ * @brief switches all packets between the 16 bit sequence of the header and a 32 bit sequence whose upper 16 bits follow the header. with the short sequence the client can not tell how many times the sequence wrapped during a long record, e.g. after about one minute at 1000 packets per second.
+ * @param enabled true for the extended sequence mode
+ */
+void Packet::setExtendedSequence(bool enabled)
+{
+    Packet::extendedSequence = enabled;
+}
+
+bool Packet::isExtendedSequence()
+{
+    return Packet::extendedSequence;
+}
+
+/**
+ * @brief responses to commands must arrive, so INFO and ERROR (and COMMAND) are RELIABLE. sensor and debug data is worthless when it arrives late and is therefore BEST_EFFORT. ACK, HEARTBEAT and PARITY packets are never tracked anyway.
+ * @return the delivery class that setMethod assigns to a packet
+ */
+NET::DeliveryClass Packet::defaultDeliveryClass(uint8_t method)
+{
+    switch (method)
+    {
+    case NET::HEADER::METHOD_COMMAND:
+    case NET::HEADER::METHOD_INFO:
+    case NET::HEADER::METHOD_ERROR:
+        return NET::DeliveryClass::RELIABLE;
+    default:
+        return NET::DeliveryClass::BEST_EFFORT;
+    }
+}
+
 /**
  * @brief returns true if the header starts with one of the flags defined in Config.h and passes the checksum test for the payload.
  * @return true if flag is ok and payload has same checksum as in the header
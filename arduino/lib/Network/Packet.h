@@ -4,6 +4,9 @@
 #include <Arduino.h>
 #include <memory>
 
+#include "PacketPool.h"
+#include "Config.h"
+
 class Packet {
 public:
     Packet();
@@ -11,36 +14,52 @@ public:
 
     void setMethod(uint8_t method);
     void setNodeIdentity(const char* nodeIdentity);
-    void setSequence(uint16_t sequence);
+    void setSequence(uint32_t sequence);
     void setPayload(const char* payload);
+    void setPayload(const uint8_t* payload, size_t length);
+    void setDeliveryClass(NET::DeliveryClass deliveryClass, uint32_t stream = 0);
 
     uint8_t getMethod();
     std::unique_ptr<char[]> getNodeIdentity();
     uint16_t getSequence();
+    uint32_t getExtendedSequence();
     uint8_t getChecksum();
     uint16_t getPayloadSize();//does not include \0 - not in cpp with strlen and not in python
     std::unique_ptr<char[]> getPayload();
+    const char* getPayloadView();
+    size_t getPayloadLength();
+    NET::DeliveryClass getDeliveryClass();
+    uint32_t getStream();
 
-    size_t getHeaderSize();
+    static size_t getHeaderSize();
     size_t getPacketSize();
 
-    uint8_t* serialize();
+    size_t serialize(uint8_t* buffer, size_t bufferSize);
+    size_t getSerializedSize();
     bool deserializeHeader(uint8_t* headerBuffer);
     bool deserializePayload(char* payloadBuffer);
+    bool deserializePayload(const uint8_t* payloadBuffer, size_t length);
     bool verifyGoodPacket();
     static bool verifyFlag(char flag);
+    static void setExtendedSequence(bool enabled);
+    static bool isExtendedSequence();
+    static NET::DeliveryClass defaultDeliveryClass(uint8_t method);
 
 private:
     uint8_t method;
     uint32_t nodeIdentity;
-    uint16_t sequence;
+    uint32_t sequence;//only the lower 16 bits are on the wire unless the extended sequence mode is enabled
     uint8_t checksum;
     uint16_t payloadSize;
-    std::unique_ptr<char[]> payload;
+    std::unique_ptr<char[], PacketPayloadDeleter> payload;
+    //local only, not part of the header
+    NET::DeliveryClass deliveryClass;
+    uint32_t stream;//packets of the same LATEST_VALUE stream replace each other in the send window
 
-    const size_t headerSize;
     size_t packetSize;
 
+    static bool extendedSequence;
+
     void setChecksum(uint8_t checksum);
     void setPayloadSize(uint16_t payloadSize);
     uint8_t calculateChecksum(char* payload, size_t length);
@@ -0,0 +1,203 @@
+#include <Arduino.h>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <mutex>
+
+#include "PacketParser.h"
+#include "PacketPool.h"
+#include "Packet.h"
+#include "Config.h"
+
+/**
+ * @class PacketParser
+ * @file PacketParser.cpp
+ * @brief A state machine that decodes packets from a byte stream independent of how the transport splits the stream.
+ *
+ * The parser searches for a method flag (SEARCH_FLAG), collects the 10 bytes of the header (HEADER) and then the payload with the size from the header (PAYLOAD). The state and the bytes collected so far are kept between calls of feed(), so a packet may arrive in any number of chunks and several packets may arrive in one chunk. Every byte is looked at exactly once.
+ * Complete packets are queued until the protocol takes them with next(). feed() and next() may be called from different tasks (e.g. the BLE callback and the main loop), therefore the queue is locked.
+ *
+ * @code
+ * PacketParser parser;
+ * parser.feed(chunk, chunkLength);
+ * std::shared_ptr<Packet> packet = parser.next(); //nullptr as long as no packet is complete
+ */
+PacketParser::PacketParser() : state(State::SEARCH_FLAG), headerIndex(0), packet(nullptr), payloadLength(0)
+{
+    this->payload.reserve(NET::MAX_BUFFER_SIZE);
+}
+
+/**
+ * @brief consumes a chunk of bytes from the transport. the chunk does not need to start or end at a packet boundary.
+ * @param data bytes received from the transport
+ * @param length number of bytes in data
+ */
+void PacketParser::feed(const uint8_t *data, size_t length)
+{
+    size_t index = 0;
+
+    while (index < length)
+    {
+        switch (this->state)
+        {
+        case State::SEARCH_FLAG:
+        {
+            // drop the bytes that are not the flag of our packet
+            while (index < length && !Packet::verifyFlag(data[index]))
+            {
+                index++;
+            }
+
+            if (index < length)
+            {
+                this->header[0] = data[index++];
+                this->headerIndex = 1;
+                this->state = State::HEADER;
+            }
+            break;
+        }
+        case State::HEADER:
+        {
+            // the header size depends on the sequence mode, see Packet::setExtendedSequence
+            size_t headerSize = Packet::getHeaderSize();
+            size_t count = min(headerSize - this->headerIndex, length - index);
+            memcpy(this->header + this->headerIndex, data + index, count);
+            this->headerIndex += count;
+            index += count;
+
+            if (this->headerIndex >= headerSize)
+            {
+                this->completeHeader();
+            }
+            break;
+        }
+        case State::PAYLOAD:
+        {
+            size_t count = min(this->payloadLength - this->payload.size(), length - index);
+            this->payload.insert(this->payload.end(), data + index, data + index + count);
+            index += count;
+
+            if (this->payload.size() == this->payloadLength)
+            {
+                this->completePacket();
+            }
+            break;
+        }
+        }
+    }
+}
+
+/**
+ * @return the oldest complete packet or nullptr if there is none
+ */
+std::shared_ptr<Packet> PacketParser::next()
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    if (this->packets.empty())
+        return nullptr;
+
+    std::shared_ptr<Packet> packet = this->packets.front();
+    this->packets.pop();
+
+    return packet;
+}
+
+bool PacketParser::hasPacket()
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    return !this->packets.empty();
+}
+
+/**
+ * @return complete packets that were not taken with next yet
+ */
+size_t PacketParser::size()
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    return this->packets.size();
+}
+
+/**
+ * @brief drops a partially received packet, e.g. when a framed transport knows that the next chunk starts a new packet.
+ */
+void PacketParser::discardPartial()
+{
+    this->state = State::SEARCH_FLAG;
+    this->headerIndex = 0;
+    this->packet = nullptr;
+    this->payload.clear();
+    this->payloadLength = 0;
+}
+
+/**
+ * @brief drops a partially received packet and all complete packets, e.g. when the transport is closed.
+ */
+void PacketParser::reset()
+{
+    this->discardPartial();
+
+    std::lock_guard<std::mutex> guard(this->lock);
+    while (!this->packets.empty())
+    {
+        this->packets.pop();
+    }
+}
+
+/**
+ * @brief the header is complete; a payload larger than NET::PARSER_MAX_PAYLOAD_SIZE can only come from a corrupted header or a flag byte inside a payload, so we search for the next flag in the header instead of waiting for that many bytes.
+ */
+void PacketParser::completeHeader()
+{
+    uint16_t payloadLength = (this->header[NET::HEADER::PAYLOADSIZE_POSITION] << 8) | this->header[NET::HEADER::PAYLOADSIZE_POSITION + 1];
+
+    if (payloadLength > NET::PARSER_MAX_PAYLOAD_SIZE)
+    {
+        this->resynchronise();
+        return;
+    }
+
+    this->packet = PacketPool::getInstance()->acquire();
+    this->packet->deserializeHeader(this->header);
+    this->payload.clear();
+    this->payloadLength = payloadLength;
+    this->state = State::PAYLOAD;
+
+    if (this->payloadLength == 0)
+    {
+        this->completePacket();
+    }
+}
+
+void PacketParser::completePacket()
+{
+    this->packet->deserializePayload(this->payload.data(), this->payload.size());
+
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->packets.push(std::move(this->packet));
+    }
+
+    this->packet = nullptr;
+    this->payload.clear();
+    this->payloadLength = 0;
+    this->state = State::SEARCH_FLAG;
+}
+
+/**
+ * @brief restarts the header at the next flag after the first byte of the rejected header, so that no bytes are skipped.
+ */
+void PacketParser::resynchronise()
+{
+    size_t start = 1;
+    while (start < this->headerIndex && !Packet::verifyFlag(this->header[start]))
+    {
+        start++;
+    }
+
+    this->headerIndex -= start;
+    memmove(this->header, this->header + start, this->headerIndex);
+    this->state = this->headerIndex > 0 ? State::HEADER : State::SEARCH_FLAG;
+}
@@ -0,0 +1,47 @@
+#ifndef PACKET_PARSER_H
+#define PACKET_PARSER_H
+
+#include <Arduino.h>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <mutex>
+
+#include "Packet.h"
+#include "Config.h"
+
+//incremental decoder that turns arbitrary chunks of bytes from a transport into complete packets
+class PacketParser {
+    public:
+        PacketParser();
+
+        void feed(const uint8_t* data, size_t length);
+        std::shared_ptr<Packet> next();
+        bool hasPacket();
+        size_t size();
+        void discardPartial();
+        void reset();
+
+    private:
+        enum class State {
+            SEARCH_FLAG,
+            HEADER,
+            PAYLOAD
+        };
+
+        State state;
+        uint8_t header[NET::HEADER::EXTENDED_SIZE];
+        size_t headerIndex;
+        std::shared_ptr<Packet> packet;
+        std::vector<uint8_t> payload;
+        size_t payloadLength;
+
+        std::mutex lock;
+        std::queue<std::shared_ptr<Packet>> packets;
+
+        void completeHeader();
+        void completePacket();
+        void resynchronise();
+};
+
+#endif
@@ -0,0 +1,169 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <memory>
+#include <mutex>
+
+#include "PacketPool.h"
+#include "Packet.h"
+#include "Config.h"
+
+/**
+ * @class PacketPool
+ * @file PacketPool.cpp
+ * @brief Provides memory for packets and their payloads from two fixed slabs that are allocated once at startup.
+ *
+ * acquire() creates the packet with std::allocate_shared so that the control block of the shared_ptr and the packet itself share one packet slot; the payload of a packet lives in a payload slot with NET::PACKET_POOL_PAYLOAD_SIZE bytes. Both slabs have NET::PACKET_POOL_SIZE slots and keep their free slots on a stack of indices, so taking and returning a slot is O(1). If the pool is exhausted or a payload is larger than a slot, the memory comes from the heap as before and is counted in the statistics, so that the pool size can be tuned with CONNECTION_READ.
+ * The pool is locked because BLE callbacks create packets on another task than the main loop.
+ */
+
+// control block of allocate_shared: vtable pointer, use count, weak count and the packet
+static const size_t PACKET_SLOT_ALIGNMENT = alignof(std::max_align_t);
+static const size_t PACKET_SLOT_SIZE = (sizeof(Packet) + 4 * sizeof(void *) + PACKET_SLOT_ALIGNMENT - 1) & ~(PACKET_SLOT_ALIGNMENT - 1);
+
+PacketPool *PacketPool::instance = nullptr;
+
+PacketPool::PacketPool() : packetSlab(new uint8_t[NET::PACKET_POOL_SIZE * PACKET_SLOT_SIZE + PACKET_SLOT_ALIGNMENT]), freePackets(new uint16_t[NET::PACKET_POOL_SIZE]), freePacketCount(NET::PACKET_POOL_SIZE), payloadSlab(new char[NET::PACKET_POOL_SIZE * NET::PACKET_POOL_PAYLOAD_SIZE]), freePayloads(new uint16_t[NET::PACKET_POOL_SIZE]), freePayloadCount(NET::PACKET_POOL_SIZE), statistics()
+{
+    for (size_t i = 0; i < NET::PACKET_POOL_SIZE; i++)
+    {
+        this->freePackets[i] = i;
+        this->freePayloads[i] = i;
+    }
+
+    this->statistics.capacity = NET::PACKET_POOL_SIZE;
+}
+
+PacketPool *PacketPool::getInstance()
+{
+    if (instance == nullptr)
+    {
+        instance = new PacketPool();
+    }
+
+    return instance;
+}
+
+/**
+ * @brief replaces std::make_shared<Packet>() on the hot path
+ * @return an empty packet whose memory is taken from the pool
+ */
+std::shared_ptr<Packet> PacketPool::acquire()
+{
+    return std::allocate_shared<Packet>(PacketPoolAllocator<Packet>());
+}
+
+/**
+ * @brief the slab is over-allocated by one alignment step so that every slot is aligned for the control block and the packet
+ */
+static uint8_t *alignedSlab(const std::unique_ptr<uint8_t[]> &slab)
+{
+    uintptr_t address = (uintptr_t)slab.get();
+    return (uint8_t *)((address + PACKET_SLOT_ALIGNMENT - 1) & ~(uintptr_t)(PACKET_SLOT_ALIGNMENT - 1));
+}
+
+void *PacketPool::allocatePacket(size_t size)
+{
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        if (size <= PACKET_SLOT_SIZE && this->freePacketCount > 0)
+        {
+            uint16_t index = this->freePackets[--this->freePacketCount];
+
+            this->statistics.packetsInUse++;
+            this->statistics.packetsHighWater = max(this->statistics.packetsHighWater, this->statistics.packetsInUse);
+
+            return alignedSlab(this->packetSlab) + index * PACKET_SLOT_SIZE;
+        }
+
+        this->statistics.packetsExhausted++;
+    }
+
+    return ::operator new(size);
+}
+
+void PacketPool::releasePacket(void *memory)
+{
+    uint8_t *slot = (uint8_t *)memory;
+    uint8_t *begin = alignedSlab(this->packetSlab);
+
+    if (slot < begin || slot >= begin + NET::PACKET_POOL_SIZE * PACKET_SLOT_SIZE)
+    {
+        ::operator delete(memory);
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->freePackets[this->freePacketCount++] = (slot - begin) / PACKET_SLOT_SIZE;
+    this->statistics.packetsInUse--;
+}
+
+/**
+ * @param size bytes of the payload including the terminating \0
+ * @return buffer that must be released with releasePayload, e.g. by PacketPayloadDeleter
+ */
+char *PacketPool::allocatePayload(size_t size)
+{
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        if (size <= NET::PACKET_POOL_PAYLOAD_SIZE && this->freePayloadCount > 0)
+        {
+            uint16_t index = this->freePayloads[--this->freePayloadCount];
+
+            this->statistics.payloadsInUse++;
+            this->statistics.payloadsHighWater = max(this->statistics.payloadsHighWater, this->statistics.payloadsInUse);
+
+            return this->payloadSlab.get() + index * NET::PACKET_POOL_PAYLOAD_SIZE;
+        }
+
+        this->statistics.payloadsExhausted++;
+    }
+
+    return new char[size];
+}
+
+void PacketPool::releasePayload(char *memory)
+{
+    char *begin = this->payloadSlab.get();
+
+    if (memory < begin || memory >= begin + NET::PACKET_POOL_SIZE * NET::PACKET_POOL_PAYLOAD_SIZE)
+    {
+        delete[] memory;
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->freePayloads[this->freePayloadCount++] = (memory - begin) / NET::PACKET_POOL_PAYLOAD_SIZE;
+    this->statistics.payloadsInUse--;
+}
+
+/**
+ * @return packets with a payload that can still be taken from the pool without using the heap
+ */
+size_t PacketPool::getRoom()
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    return min(this->freePacketCount, this->freePayloadCount);
+}
+
+PacketPoolStatistics PacketPool::getStatistics()
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    return this->statistics;
+}
+
+void PacketPool::getStatistics(JsonObject &json)
+{
+    PacketPoolStatistics statistics = this->getStatistics();
+
+    json["capacity"] = statistics.capacity;
+    json["packets_in_use"] = statistics.packetsInUse;
+    json["packets_high_water"] = statistics.packetsHighWater;
+    json["packets_exhausted"] = statistics.packetsExhausted;
+    json["payloads_in_use"] = statistics.payloadsInUse;
+    json["payloads_high_water"] = statistics.payloadsHighWater;
+    json["payloads_exhausted"] = statistics.payloadsExhausted;
+}
@@ -0,0 +1,85 @@
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <memory>
+#include <mutex>
+
+class Packet;
+
+struct PacketPoolStatistics {
+    size_t capacity; //number of packet and payload slots
+    size_t packetsInUse;
+    size_t packetsHighWater; //highest number of packet slots that were in use at the same time
+    unsigned long packetsExhausted; //packets that were allocated on the heap because all slots were in use
+    size_t payloadsInUse;
+    size_t payloadsHighWater;
+    unsigned long payloadsExhausted; //payloads that were allocated on the heap because all slots were in use or the payload was too large
+};
+
+//fixed slab of packet and payload slots so that packets on the hot path do not fragment the heap
+class PacketPool {
+    public:
+        //https://refactoring.guru/design-patterns/singleton/cpp/example
+        static PacketPool* getInstance();
+
+        std::shared_ptr<Packet> acquire();
+
+        void* allocatePacket(size_t size);
+        void releasePacket(void* memory);
+        char* allocatePayload(size_t size);
+        void releasePayload(char* memory);
+
+        size_t getRoom();
+        PacketPoolStatistics getStatistics();
+        void getStatistics(JsonObject& json);
+
+    private:
+        PacketPool();// Private constructor
+
+        static PacketPool *instance; // Static instance pointer
+        std::mutex lock;
+
+        std::unique_ptr<uint8_t[]> packetSlab;
+        std::unique_ptr<uint16_t[]> freePackets;
+        size_t freePacketCount;
+
+        std::unique_ptr<char[]> payloadSlab;
+        std::unique_ptr<uint16_t[]> freePayloads;
+        size_t freePayloadCount;
+
+        PacketPoolStatistics statistics;
+};
+
+//allocator for std::allocate_shared which puts the control block of the shared_ptr and the packet in one slot of the pool
+template <typename T>
+struct PacketPoolAllocator {
+    typedef T value_type;
+
+    PacketPoolAllocator() = default;
+    template <typename U>
+    PacketPoolAllocator(const PacketPoolAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(PacketPool::getInstance()->allocatePacket(n * sizeof(T)));
+    }
+
+    void deallocate(T* memory, size_t n) {
+        PacketPool::getInstance()->releasePacket(memory);
+    }
+
+    template <typename U>
+    bool operator==(const PacketPoolAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const PacketPoolAllocator<U>&) const { return false; }
+};
+
+//returns payload buffers of a packet to the pool
+struct PacketPayloadDeleter {
+    void operator()(char* memory) const {
+        PacketPool::getInstance()->releasePayload(memory);
+    }
+};
+
+#endif
@@ -1,6 +1,5 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <queue>
 #include <vector>
 #include <memory>
 
@@ -21,7 +20,7 @@ PacketRelay *PacketRelay::getInstance() {
     return instance;
 }
 
-void PacketRelay::setQueue(std::queue<std::shared_ptr<Packet>> *queue) {
+void PacketRelay::setQueue(OutputQueue *queue) {
     if (this->packetQueue == nullptr) {
         this->packetQueue = queue;
     }
@@ -30,30 +29,56 @@ void PacketRelay::setQueue(std::queue<std::shared_ptr<Packet>> *queue) {
 void PacketRelay::info(char* payload) {
     if (this->packetQueue == nullptr) return;
 
-    std::shared_ptr<Packet> packet = std::make_shared<Packet>();
+    std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
     packet->setMethod(NET::HEADER::METHOD_INFO);
     packet->setPayload(payload);
 
     this->packetQueue->push(std::move(packet));
 }
 
+/**
+ * @brief queues a heartbeat with the uptime of the device as binary payload (see NET::HEARTBEAT_PAYLOAD_SIZE), so the client can also detect a restart
+ */
 void PacketRelay::heartbeat() {
     if (this->packetQueue == nullptr) return;
-    
-    std::shared_ptr<Packet> packet = std::make_shared<Packet>();   
+
+    uint32_t uptime = millis();
+    uint8_t payload[NET::HEARTBEAT_PAYLOAD_SIZE] = {
+        (uint8_t)(uptime >> 24), (uint8_t)(uptime >> 16), (uint8_t)(uptime >> 8), (uint8_t)(uptime >> 0)
+    };
+
+    std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();   
     packet->setMethod(NET::HEADER::METHOD_HEARTBEAT);
-    packet->setPayload("{}");
+    packet->setPayload(payload, sizeof(payload));
 
     this->packetQueue->push(std::move(packet));
 }
 
-void PacketRelay::ack(char* payload) {
+/**
+ * @brief queues a cumulative ACK with the binary payload described at NET::ACK_PAYLOAD_SIZE; no json is built for control packets
+ * @param sequence the next expected sequence; all packets before it were received
+ * @param bitmap bit i is set if the packet sequence + 1 + i was received
+ */
+void PacketRelay::ack(uint16_t sequence, uint32_t bitmap) {
     if (this->packetQueue == nullptr) return;
 
-    std::shared_ptr<Packet> packet = std::make_shared<Packet>();   
+    uint8_t payload[NET::ACK_PAYLOAD_SIZE] = {
+        (uint8_t)(sequence >> 8), (uint8_t)(sequence >> 0),
+        (uint8_t)(bitmap >> 24), (uint8_t)(bitmap >> 16), (uint8_t)(bitmap >> 8), (uint8_t)(bitmap >> 0)
+    };
+
+    std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();   
     packet->setMethod(NET::HEADER::METHOD_ACKNOWLEDGEMENT);
-    packet->setPayload(payload);
+    packet->setPayload(payload, sizeof(payload));
 
     this->packetQueue->push(std::move(packet));
 }
 
+/**
+ * @brief queues a packet that was already built by the caller, e.g. a batch of sensor samples
+ */
+void PacketRelay::send(std::shared_ptr<Packet> packet) {
+    if (this->packetQueue == nullptr || packet == nullptr) return;
+
+    this->packetQueue->push(std::move(packet));
+}
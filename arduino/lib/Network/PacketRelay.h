@@ -4,28 +4,29 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <map>
-#include <queue>
 #include <vector>
 #include <memory>
 
 #include "Packet.h"
+#include "OutputQueue.h"
 
 class PacketRelay {
     public:
         //https://refactoring.guru/design-patterns/singleton/cpp/example
         static PacketRelay* getInstance();
 
-        void setQueue(std::queue<std::shared_ptr<Packet>> *queue);
+        void setQueue(OutputQueue *queue);
 
         void info(char* payload);
         void heartbeat();
-        void ack(char* payload);
+        void ack(uint16_t sequence, uint32_t bitmap);
+        void send(std::shared_ptr<Packet> packet);
         
     private:
         PacketRelay();// Private constructor
         
         static PacketRelay *instance; // Static instance pointer
-        std::queue<std::shared_ptr<Packet>> *packetQueue;
+        OutputQueue *packetQueue;
 };
 
 #endif
@@ -0,0 +1,108 @@
+#include <Arduino.h>
+#include <vector>
+#include <memory>
+
+#include "ParityEncoder.h"
+#include "Packet.h"
+#include "PacketPool.h"
+#include "Config.h"
+
+/**
+ * @class ParityEncoder
+ * @file ParityEncoder.cpp
+ * @brief Creates one METHOD_PARITY packet for every groupSize data packets.
+ *
+ * The parity packet holds the XOR of the method flags, of the payload lengths and of the payloads (shorter payloads are padded with 0x00) of the group. If exactly one packet of the group is lost, the client XORs the parity with the packets it received and gets the method, length and payload of the lost packet; the sequence is the one of the group that is missing. This costs 1/groupSize extra bandwidth but no round trip, which matters for live data where a retransmission arrives too late.
+ * The payload of a parity packet is binary with fields in big endian like the header:
+ * [count: uint8][sequence: uint16 * count][method parity: uint8][length parity: uint16][payload parity: bytes of the longest payload]
+ * In the worst case the payload has NET::FEC_PARITY_OVERHEAD (1 + 2 * NET::FEC_MAX_GROUP_SIZE + 3 = 36) bytes plus the longest payload of the group. A group of full batches therefore gives a parity packet of NET::HEADER::EXTENDED_SIZE + NET::FEC_PARITY_OVERHEAD + DEVICE::BATCH_MAX_PAYLOAD_SIZE = NET::MAX_BUFFER_SIZE bytes; DEVICE::BATCH_MAX_PAYLOAD_SIZE is derived from this bound. Only a sample that is sent on its own because it is larger than a batch can make the parity packet larger.
+ */
+ParityEncoder::ParityEncoder() : groupSize(DEVICE::FEC_GROUP_SIZE), methodParity(0), lengthParity(0)
+{
+    this->sequences.reserve(NET::FEC_MAX_GROUP_SIZE);
+    this->payloadParity.reserve(NET::MAX_BUFFER_SIZE);
+    this->parityFrame.reserve(NET::MAX_BUFFER_SIZE);
+}
+
+/**
+ * @param groupSize data packets per parity packet; 0 and 1 disable the parity packets, values above NET::FEC_MAX_GROUP_SIZE are limited to it
+ */
+void ParityEncoder::configure(uint8_t groupSize)
+{
+    this->groupSize = min(groupSize, NET::FEC_MAX_GROUP_SIZE);
+    this->reset();
+}
+
+uint8_t ParityEncoder::getGroupSize()
+{
+    return this->groupSize;
+}
+
+bool ParityEncoder::isEnabled()
+{
+    return this->groupSize > 1;
+}
+
+/**
+ * @brief adds a data packet that already has its sequence to the current group.
+ * @return the parity packet if the group is complete; nullptr otherwise
+ */
+std::shared_ptr<Packet> ParityEncoder::add(std::shared_ptr<Packet> &packet)
+{
+    if (!this->isEnabled())
+        return nullptr;
+
+    const uint8_t *payload = (const uint8_t *)packet->getPayloadView();
+    size_t length = packet->getPayloadLength();
+
+    if (this->payloadParity.size() < length)
+        this->payloadParity.resize(length, 0);
+
+    for (size_t i = 0; i < length; i++)
+    {
+        this->payloadParity[i] ^= payload[i];
+    }
+
+    this->methodParity ^= packet->getMethod();
+    this->lengthParity ^= length;
+    this->sequences.push_back(packet->getSequence());
+
+    if (this->sequences.size() < this->groupSize)
+        return nullptr;
+
+    std::shared_ptr<Packet> parity = this->createParityPacket();
+    this->reset();
+
+    return parity;
+}
+
+void ParityEncoder::reset()
+{
+    this->sequences.clear();
+    this->methodParity = 0;
+    this->lengthParity = 0;
+    this->payloadParity.clear();
+}
+
+std::shared_ptr<Packet> ParityEncoder::createParityPacket()
+{
+    std::vector<uint8_t> &payload = this->parityFrame;
+    payload.clear();
+
+    payload.push_back(this->sequences.size());
+    for (uint16_t sequence : this->sequences)
+    {
+        payload.push_back(sequence >> 8);
+        payload.push_back(sequence >> 0);
+    }
+    payload.push_back(this->methodParity);
+    payload.push_back(this->lengthParity >> 8);
+    payload.push_back(this->lengthParity >> 0);
+    payload.insert(payload.end(), this->payloadParity.begin(), this->payloadParity.end());
+
+    std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+    packet->setMethod(NET::HEADER::METHOD_PARITY);
+    packet->setPayload(payload.data(), payload.size());
+
+    return packet;
+}
@@ -0,0 +1,32 @@
+#ifndef PARITY_ENCODER_H
+#define PARITY_ENCODER_H
+
+#include <Arduino.h>
+#include <vector>
+#include <memory>
+
+#include "Packet.h"
+
+//forward error correction: XOR parity over a group of data packets so that the client can rebuild one lost packet per group without a retransmission
+class ParityEncoder {
+    public:
+        ParityEncoder();
+
+        void configure(uint8_t groupSize);
+        uint8_t getGroupSize();
+        bool isEnabled();
+        std::shared_ptr<Packet> add(std::shared_ptr<Packet> &packet);
+        void reset();
+
+    private:
+        uint8_t groupSize;
+        std::vector<uint16_t> sequences;
+        uint8_t methodParity;
+        uint16_t lengthParity;
+        std::vector<uint8_t> payloadParity;
+        std::vector<uint8_t> parityFrame;//payload of the parity packet; reused for every group
+
+        std::shared_ptr<Packet> createParityPacket();
+};
+
+#endif
@@ -1,8 +1,87 @@
 #include "ProtocolBase.h"
 #include "Config.h"
+#include "TaskSignal.h"
 
-ProtocolBase::ProtocolBase(String name, uint16_t bufferSize): name(name), bufferSize(bufferSize) {}
+ProtocolBase::ProtocolBase(String name, uint16_t bufferSize): name(name), bufferSize(bufferSize), txBuffer(new uint8_t[bufferSize]), txBufferSize(bufferSize) {}
 
 String ProtocolBase::getName() {
     return this->name;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief sets the signal that is notified when the protocol received data, so that the task which reads the packets does not have to poll
+ */
+void ProtocolBase::setDataSignal(TaskSignal *signal) {
+    this->dataSignal = signal;
+}
+
+/**
+ * @return complete packets that were received but not yet taken with readPacket
+ */
+size_t ProtocolBase::getPendingPackets() {
+    return this->parser.size();
+}
+
+/**
+ * @return milli seconds after which readPacket must be called again because the protocol can not signal received data; UTIL::NO_DEADLINE if it signals all data
+ */
+unsigned long ProtocolBase::getPollInterval() {
+    return UTIL::NO_DEADLINE;
+}
+
+/**
+ * @brief serialises the packet into the tx buffer of this protocol so that writing a packet does not allocate memory on the heap. the tx buffer starts with bufferSize bytes and only grows if a packet does not fit into it (e.g. large capability responses); it is never shrunk so that the next packet of that size can reuse it.
+ * @param packet the packet to serialise
+ * @return number of bytes in the tx buffer that must be written to the network
+ */
+size_t ProtocolBase::serializeToTxBuffer(std::shared_ptr<Packet> &packet) {
+    this->reserveTxBuffer(packet->getSerializedSize());
+
+    return packet->serialize(this->txBuffer.get(), this->txBufferSize);
+}
+
+/**
+ * @brief serialises the packets back to back into the tx buffer, so that a stream transport can write them with one call
+ * @return number of bytes in the tx buffer that must be written to the network
+ */
+size_t ProtocolBase::serializeToTxBuffer(std::vector<std::shared_ptr<Packet>> &packets) {
+    size_t serializedSize = 0;
+    for (std::shared_ptr<Packet> &packet : packets) {
+        serializedSize += packet->getSerializedSize();
+    }
+
+    this->reserveTxBuffer(serializedSize);
+
+    size_t offset = 0;
+    for (std::shared_ptr<Packet> &packet : packets) {
+        offset += packet->serialize(this->txBuffer.get() + offset, this->txBufferSize - offset);
+    }
+
+    return offset;
+}
+
+/**
+ * @brief writes several packets at once. the default writes them one by one; protocols that send a byte stream override it to write the whole batch with one transport operation.
+ */
+void ProtocolBase::writePackets(std::vector<std::shared_ptr<Packet>> &packets) {
+    for (std::shared_ptr<Packet> &packet : packets) {
+        this->writePacket(packet);
+    }
+}
+
+uint8_t* ProtocolBase::getTxBuffer() {
+    return this->txBuffer.get();
+}
+
+//called by the protocol when bytes were received, usually from the task of the driver
+void ProtocolBase::signalData() {
+    if (this->dataSignal != nullptr)
+        this->dataSignal->notify();
+}
+
+void ProtocolBase::reserveTxBuffer(size_t size) {
+    if (size > this->txBufferSize) {
+        this->txBuffer.reset(new uint8_t[size]);
+        this->txBufferSize = size;
+    }
+}
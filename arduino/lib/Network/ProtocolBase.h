@@ -3,8 +3,11 @@
 
 #include <Arduino.h>
 #include <memory>
+#include <vector>
 
 #include "Packet.h"
+#include "PacketParser.h"
+#include "TaskSignal.h"
 
 class ProtocolBase {
     public:
@@ -12,14 +15,31 @@ class ProtocolBase {
         virtual void init() = 0;
         virtual void destroy() = 0;
         virtual void writePacket(std::shared_ptr<Packet> packet) = 0;
+        virtual void writePackets(std::vector<std::shared_ptr<Packet>> &packets);
         virtual std::shared_ptr<Packet> readPacket() = 0;
         virtual bool checkConnection() = 0;
+        virtual unsigned long getPollInterval();
+        virtual size_t getPendingPackets();
         String getName();
+        void setDataSignal(TaskSignal *signal);
 
     protected:
         const String name;
         bool connected = false;
         uint16_t bufferSize;
+        PacketParser parser;
+        TaskSignal *dataSignal = nullptr;
+
+        size_t serializeToTxBuffer(std::shared_ptr<Packet> &packet);
+        size_t serializeToTxBuffer(std::vector<std::shared_ptr<Packet>> &packets);
+        uint8_t* getTxBuffer();
+        void signalData();
+
+    private:
+        std::unique_ptr<uint8_t[]> txBuffer;
+        size_t txBufferSize;
+
+        void reserveTxBuffer(size_t size);
 };
 
 #endif
\ No newline at end of file
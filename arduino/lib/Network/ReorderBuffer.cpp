@@ -0,0 +1,140 @@
+#include <Arduino.h>
+#include <vector>
+#include <memory>
+
+#include "ReorderBuffer.h"
+#include "Packet.h"
+#include "Config.h"
+
+static_assert(NET::REORDER_BUFFER_SIZE == 32, "the occupancy bitmap of the reorder buffer is a uint32_t");
+
+/**
+ * @class ReorderBuffer
+ * @file ReorderBuffer.cpp
+ * @brief Puts incoming packets back into the order of their sequence with bounded work per packet.
+ *
+ * A packet that arrives before the expected sequence is stored at seq % NET::REORDER_BUFFER_SIZE and marked in the occupancy bitmap, where bit i stands for the sequence expectedSequence + 1 + i. This is the same bitmap that is sent to the client in the sack field of an ACK.
+ * When the expected packet arrives, the run of consecutive packets behind it is found with one count-trailing-zeros operation on the inverted bitmap, and jumping over a gap to the nearest stored packet is a count-trailing-zeros on the bitmap itself. Therefore no operation steps through the sequence space one number at a time and the work per packet is bounded by the size of the buffer.
+ */
+ReorderBuffer::ReorderBuffer() : occupied(0), expectedSequence(0) {}
+
+uint16_t ReorderBuffer::getExpectedSequence()
+{
+    return this->expectedSequence;
+}
+
+uint32_t ReorderBuffer::getBitmap()
+{
+    return this->occupied;
+}
+
+size_t ReorderBuffer::size()
+{
+    return __builtin_popcount(this->occupied);
+}
+
+bool ReorderBuffer::isEmpty()
+{
+    return this->occupied == 0;
+}
+
+/**
+ * @brief appends the packet with the expected sequence and all stored packets that directly follow it to the output.
+ * @param packet must have the expected sequence
+ */
+void ReorderBuffer::deliver(std::shared_ptr<Packet> packet, std::vector<std::shared_ptr<Packet>> &output)
+{
+    output.push_back(std::move(packet));
+    this->drain(output);
+}
+
+/**
+ * @brief stores a packet that arrived before the expected sequence. a packet that is already stored is dropped as double.
+ * @return false if the sequence is too far ahead to be stored
+ */
+bool ReorderBuffer::store(std::shared_ptr<Packet> packet)
+{
+    uint16_t offset = packet->getSequence() - this->expectedSequence - 1;
+
+    if (offset >= NET::REORDER_BUFFER_SIZE)
+        return false;
+
+    if ((this->occupied & ((uint32_t)1 << offset)) == 0)
+    {
+        this->slots[packet->getSequence() % NET::REORDER_BUFFER_SIZE] = std::move(packet);
+        this->occupied |= (uint32_t)1 << offset;
+    }
+
+    return true;
+}
+
+/**
+ * @brief gives up the missing packets before the nearest stored packet and delivers it with the packets that directly follow it.
+ */
+void ReorderBuffer::skipGap(std::vector<std::shared_ptr<Packet>> &output)
+{
+    if (this->occupied == 0)
+        return;
+
+    uint8_t gap = __builtin_ctz(this->occupied);
+    uint16_t sequence = this->expectedSequence + 1 + gap;
+
+    output.push_back(this->take(sequence));
+    this->expectedSequence = sequence;
+    this->shift(gap + 1);
+
+    this->drain(output);
+}
+
+/**
+ * @brief the packet is too far ahead to be stored, e.g. after a long disconnect. all stored packets are delivered in order (skipping the gaps) and the packet becomes the new expected sequence.
+ */
+void ReorderBuffer::resynchronise(std::shared_ptr<Packet> packet, std::vector<std::shared_ptr<Packet>> &output)
+{
+    while (this->occupied != 0)
+    {
+        this->skipGap(output);
+    }
+
+    this->expectedSequence = packet->getSequence();
+    this->deliver(std::move(packet), output);
+}
+
+void ReorderBuffer::clear()
+{
+    for (size_t i = 0; i < NET::REORDER_BUFFER_SIZE; i++)
+    {
+        this->slots[i] = nullptr;
+    }
+
+    this->occupied = 0;
+}
+
+std::shared_ptr<Packet> ReorderBuffer::take(uint16_t sequence)
+{
+    std::shared_ptr<Packet> packet = std::move(this->slots[sequence % NET::REORDER_BUFFER_SIZE]);
+    this->slots[sequence % NET::REORDER_BUFFER_SIZE] = nullptr;
+
+    return packet;
+}
+
+/**
+ * @brief the packet with the expected sequence was delivered; deliver the run of stored packets behind it and expect the first sequence after the run.
+ */
+void ReorderBuffer::drain(std::vector<std::shared_ptr<Packet>> &output)
+{
+    uint8_t run = this->occupied == UINT32_MAX ? NET::REORDER_BUFFER_SIZE : __builtin_ctz(~this->occupied);
+
+    for (uint8_t i = 0; i < run; i++)
+    {
+        output.push_back(this->take(this->expectedSequence + 1 + i));
+    }
+
+    this->expectedSequence += run + 1;
+    this->shift(run + 1);
+}
+
+void ReorderBuffer::shift(uint8_t count)
+{
+    this->occupied = count >= NET::REORDER_BUFFER_SIZE ? 0 : this->occupied >> count;
+}
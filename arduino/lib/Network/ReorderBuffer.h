@@ -0,0 +1,37 @@
+#ifndef REORDER_BUFFER_H
+#define REORDER_BUFFER_H
+
+#include <Arduino.h>
+#include <vector>
+#include <memory>
+
+#include "Packet.h"
+#include "Config.h"
+
+//fixed circular buffer for packets that arrived before the expected sequence; bit i of the occupancy bitmap is the packet expectedSequence + 1 + i
+class ReorderBuffer {
+    public:
+        ReorderBuffer();
+
+        uint16_t getExpectedSequence();
+        uint32_t getBitmap();
+        size_t size();
+        bool isEmpty();
+
+        void deliver(std::shared_ptr<Packet> packet, std::vector<std::shared_ptr<Packet>> &output);
+        bool store(std::shared_ptr<Packet> packet);
+        void skipGap(std::vector<std::shared_ptr<Packet>> &output);
+        void resynchronise(std::shared_ptr<Packet> packet, std::vector<std::shared_ptr<Packet>> &output);
+        void clear();
+
+    private:
+        std::shared_ptr<Packet> slots[NET::REORDER_BUFFER_SIZE];
+        uint32_t occupied;
+        uint16_t expectedSequence;
+
+        std::shared_ptr<Packet> take(uint16_t sequence);
+        void drain(std::vector<std::shared_ptr<Packet>> &output);
+        void shift(uint8_t count);
+};
+
+#endif
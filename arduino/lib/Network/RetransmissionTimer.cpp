@@ -0,0 +1,72 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <math.h>
+
+#include "RetransmissionTimer.h"
+#include "Config.h"
+
+/**
+ * @class RetransmissionTimer
+ * @file RetransmissionTimer.cpp
+ * @brief Computes the retransmission timeout (RTO) of the send window from measured round trip times.
+ *
+ * The first measurement R sets SRTT = R and RTTVAR = R/2; every further measurement updates RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R| and SRTT = 7/8 SRTT + 1/8 R. The timeout is RTO = SRTT + max(G, 4 RTTVAR) limited to NET::RTO_MIN and NET::RTO_MAX, where G is the granularity of millis(). Each expiry doubles the timeout until the next measurement.
+ * Only packets that were sent once are measured (Karn's algorithm), because the ACK of a retransmitted packet can not be matched to one of its transmissions.
+ *
+ * @cite https://www.rfc-editor.org/rfc/rfc6298
+ */
+RetransmissionTimer::RetransmissionTimer()
+{
+    this->reset();
+}
+
+/**
+ * @param roundTripTime milli seconds between sending a packet and receiving its ACK
+ */
+void RetransmissionTimer::sample(unsigned long roundTripTime)
+{
+    float measurement = roundTripTime;
+
+    if (!this->hasSample)
+    {
+        this->smoothedRoundTripTime = measurement;
+        this->roundTripTimeVariation = measurement / 2;
+        this->hasSample = true;
+    }
+    else
+    {
+        this->roundTripTimeVariation = 0.75f * this->roundTripTimeVariation + 0.25f * fabsf(this->smoothedRoundTripTime - measurement);
+        this->smoothedRoundTripTime = 0.875f * this->smoothedRoundTripTime + 0.125f * measurement;
+    }
+
+    unsigned long timeout = this->smoothedRoundTripTime + max(1.0f, 4 * this->roundTripTimeVariation);
+    this->timeout = constrain(timeout, NET::RTO_MIN, NET::RTO_MAX);
+}
+
+/**
+ * @brief called when a packet was not acknowledged within the timeout.
+ */
+void RetransmissionTimer::backoff()
+{
+    this->timeout = min(this->timeout * 2, NET::RTO_MAX);
+}
+
+void RetransmissionTimer::reset()
+{
+    this->hasSample = false;
+    this->smoothedRoundTripTime = 0;
+    this->roundTripTimeVariation = 0;
+    this->timeout = NET::RTO_INITIAL;
+}
+
+unsigned long RetransmissionTimer::getTimeout()
+{
+    return this->timeout;
+}
+
+void RetransmissionTimer::getStatistics(JsonObject &json)
+{
+    json["srtt"] = this->smoothedRoundTripTime;
+    json["rttvar"] = this->roundTripTimeVariation;
+    json["rto"] = this->timeout;
+}
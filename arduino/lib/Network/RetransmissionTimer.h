@@ -0,0 +1,25 @@
+#ifndef RETRANSMISSION_TIMER_H
+#define RETRANSMISSION_TIMER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+//estimates the round trip time from ACK packets and derives the retransmission timeout like RFC 6298
+class RetransmissionTimer {
+    public:
+        RetransmissionTimer();
+
+        void sample(unsigned long roundTripTime);
+        void backoff();
+        void reset();
+        unsigned long getTimeout();
+        void getStatistics(JsonObject &json);
+
+    private:
+        bool hasSample;
+        float smoothedRoundTripTime;//SRTT in milli seconds
+        float roundTripTimeVariation;//RTTVAR in milli seconds
+        unsigned long timeout;//RTO in milli seconds
+};
+
+#endif
@@ -0,0 +1,283 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include <memory>
+
+#include "SendWindow.h"
+#include "Packet.h"
+#include "Config.h"
+
+static_assert((NET::SEND_WINDOW_SIZE & (NET::SEND_WINDOW_SIZE - 1)) == 0, "NET::SEND_WINDOW_SIZE must be a power of two so that seq % size stays consistent when the sequence overflows");
+
+/**
+ * @class SendWindow
+ * @file SendWindow.cpp
+ * @brief Keeps the packets that IntegrityMiddleware may have to resend in a fixed array instead of a map that grows with every unacknowledged packet.
+ *
+ * Only RELIABLE and LATEST_VALUE packets are kept (see NET::DeliveryClass); BEST_EFFORT packets get a sequence as well, so the sequences in the window have gaps. The slot of a sequence is seq % NET::SEND_WINDOW_SIZE and a slot holds at most one packet, therefore inserting a packet is O(1) and acknowledging or looking up a sequence is O(1) plus a check that the slot holds this sequence. Operations that concern all packets (cumulative ACK, retransmissions) scan the NET::SEND_WINDOW_SIZE slots.
+ * Every slot also keeps the time of the last transmission and the number of transmissions, so that IntegrityMiddleware can retransmit packets whose ACK did not arrive within the retransmission timeout and measure the round trip time.
+ * If the slot of the next packet is still taken, the older packet must leave first. With NET::SendWindowPolicy::DROP_OLDEST_DATA, it is evicted if it is not RELIABLE. RELIABLE packets are never evicted; in this case and with NET::SendWindowPolicy::BLOCK the next packet waits in the output queue until an ACK frees the slot.
+ * A LATEST_VALUE packet replaces the unacknowledged packet of the same stream because only the latest state of e.g. a button is worth a retransmission.
+ */
+SendWindow::SendWindow(NET::SendWindowPolicy policy) : inFlight(0), policy(policy), evictedPackets(0), blockedPackets(0), retransmittedPackets(0), expiredPackets(0), supersededPackets(0) {}
+
+/**
+ * @brief checks if the packet can be sent now and makes room for it according to the policy.
+ * @param packet the packet that is sent next
+ * @param sequence the sequence that the packet will get
+ * @return false if the packet must wait until an ACK frees its slot
+ */
+bool SendWindow::reserve(std::shared_ptr<Packet> &packet, uint16_t sequence)
+{
+    if (packet->getDeliveryClass() == NET::DeliveryClass::LATEST_VALUE)
+        this->supersede(packet);
+
+    Entry &entry = this->slots[sequence % NET::SEND_WINDOW_SIZE];
+    if (entry.packet == nullptr)
+        return true;
+
+    if (this->policy == NET::SendWindowPolicy::DROP_OLDEST_DATA && this->isEvictable(entry.packet))
+    {
+        this->release(entry);
+        this->evictedPackets++;
+
+        return true;
+    }
+
+    this->blockedPackets++;
+
+    return false;
+}
+
+/**
+ * @brief stores the packet in its slot. reserve must have returned true for the sequence of the packet.
+ * @param now millis() when the packet is written to the network
+ */
+void SendWindow::insert(std::shared_ptr<Packet> packet, unsigned long now)
+{
+    Entry &entry = this->slots[packet->getSequence() % NET::SEND_WINDOW_SIZE];
+    if (entry.packet == nullptr)
+        this->inFlight++;
+
+    entry.packet = std::move(packet);
+    entry.sentAt = now;
+    entry.transmissions = 1;
+    entry.resendRequested = false;
+}
+
+/**
+ * @brief frees the slot of an acknowledged packet.
+ * @param roundTripTime is set to the time since the transmission if the packet was sent only once
+ * @return true if roundTripTime is a valid measurement
+ */
+bool SendWindow::acknowledge(uint16_t sequence, unsigned long now, unsigned long &roundTripTime)
+{
+    Entry *entry = this->find(sequence);
+    if (entry == nullptr)
+        return false;
+
+    bool measured = entry->transmissions == 1;
+    roundTripTime = now - entry->sentAt;
+
+    this->release(*entry);
+
+    return measured;
+}
+
+/**
+ * @brief frees the slots of all packets before the sequence (cumulative ACK).
+ * @param sequence the client received every packet before this sequence
+ * @param roundTripTime is set to the smallest time since the transmission of a packet that was sent only once
+ * @return true if roundTripTime is a valid measurement
+ */
+bool SendWindow::acknowledgeUpTo(uint16_t sequence, unsigned long now, unsigned long &roundTripTime)
+{
+    bool measured = false;
+
+    for (size_t i = 0; i < NET::SEND_WINDOW_SIZE && this->inFlight > 0; i++)
+    {
+        Entry &entry = this->slots[i];
+
+        // serial number arithmetic: the packet is before the sequence if the difference is negative as a signed 16 bit number
+        if (entry.packet == nullptr || (int16_t)(entry.packet->getSequence() - sequence) >= 0)
+            continue;
+
+        unsigned long packetRoundTripTime = now - entry.sentAt;
+        if (entry.transmissions == 1)
+        {
+            roundTripTime = measured ? min(roundTripTime, packetRoundTripTime) : packetRoundTripTime;
+            measured = true;
+        }
+
+        this->release(entry);
+    }
+
+    return measured;
+}
+
+/**
+ * @return the packet with the sequence or nullptr if it is acknowledged, evicted or was never kept
+ */
+std::shared_ptr<Packet> SendWindow::get(uint16_t sequence)
+{
+    Entry *entry = this->find(sequence);
+
+    return entry != nullptr ? entry->packet : nullptr;
+}
+
+/**
+ * @brief marks the packet for retransmission without waiting for the timeout, e.g. because the client reported it as missing.
+ */
+void SendWindow::requestResend(uint16_t sequence)
+{
+    Entry *entry = this->find(sequence);
+    if (entry != nullptr)
+        entry->resendRequested = true;
+}
+
+/**
+ * @brief marks the packet for retransmission if it was sent only once. the client reports a gap with every ACK until the packet arrives, so only the first report triggers a retransmission; later ones wait for the timeout.
+ */
+void SendWindow::requestFastRetransmit(uint16_t sequence)
+{
+    Entry *entry = this->find(sequence);
+    if (entry != nullptr && entry->transmissions == 1)
+        entry->resendRequested = true;
+}
+
+/**
+ * @brief collects the packets that must be sent again because their ACK did not arrive within the timeout or because a resend was requested. a packet that was already sent NET::MAX_TRANSMISSIONS times is removed instead so that it does not occupy the window forever.
+ * @param now millis() when the packets are written to the network
+ * @param timeout the current retransmission timeout in milli seconds
+ * @param output the packets to retransmit are appended
+ * @return true if at least one packet timed out which requires a backoff of the timeout
+ */
+bool SendWindow::collectRetransmissions(unsigned long now, unsigned long timeout, std::vector<std::shared_ptr<Packet>> &output)
+{
+    bool timedOut = false;
+
+    for (size_t i = 0; i < NET::SEND_WINDOW_SIZE; i++)
+    {
+        Entry &entry = this->slots[i];
+
+        if (entry.packet == nullptr)
+            continue;
+
+        bool expired = now - entry.sentAt >= timeout;
+        if (!expired && !entry.resendRequested)
+            continue;
+
+        timedOut |= expired;
+
+        if (entry.transmissions >= NET::MAX_TRANSMISSIONS)
+        {
+            this->release(entry);
+            this->expiredPackets++;
+            continue;
+        }
+
+        entry.sentAt = now;
+        entry.transmissions++;
+        entry.resendRequested = false;
+        this->retransmittedPackets++;
+
+        output.push_back(entry.packet);
+    }
+
+    return timedOut;
+}
+
+/**
+ * @return milli seconds until collectRetransmissions has the next packet to send again; UTIL::NO_DEADLINE if the window is empty
+ */
+unsigned long SendWindow::getTimeToRetransmission(unsigned long now, unsigned long timeout)
+{
+    unsigned long time = UTIL::NO_DEADLINE;
+
+    for (size_t i = 0; i < NET::SEND_WINDOW_SIZE && time > 0; i++)
+    {
+        Entry &entry = this->slots[i];
+
+        if (entry.packet == nullptr)
+            continue;
+
+        unsigned long waited = now - entry.sentAt;
+        time = min(time, entry.resendRequested || waited >= timeout ? 0 : timeout - waited);
+    }
+
+    return time;
+}
+
+void SendWindow::clear()
+{
+    for (size_t i = 0; i < NET::SEND_WINDOW_SIZE; i++)
+    {
+        this->release(this->slots[i]);
+    }
+}
+
+bool SendWindow::isFull()
+{
+    return this->getInFlight() >= NET::SEND_WINDOW_SIZE;
+}
+
+size_t SendWindow::getInFlight()
+{
+    return this->inFlight;
+}
+
+void SendWindow::getStatistics(JsonObject &json)
+{
+    json["size"] = NET::SEND_WINDOW_SIZE;
+    json["in_flight"] = this->getInFlight();
+    json["evicted"] = this->evictedPackets;
+    json["blocked"] = this->blockedPackets;
+    json["retransmitted"] = this->retransmittedPackets;
+    json["expired"] = this->expiredPackets;
+    json["superseded"] = this->supersededPackets;
+}
+
+/**
+ * @return the slot that holds the packet with the sequence or nullptr if the packet is not kept
+ */
+SendWindow::Entry* SendWindow::find(uint16_t sequence)
+{
+    Entry &entry = this->slots[sequence % NET::SEND_WINDOW_SIZE];
+    if (entry.packet == nullptr || entry.packet->getSequence() != sequence)
+        return nullptr;
+
+    return &entry;
+}
+
+bool SendWindow::isEvictable(std::shared_ptr<Packet> &packet)
+{
+    return packet == nullptr || packet->getDeliveryClass() != NET::DeliveryClass::RELIABLE;
+}
+
+/**
+ * @brief frees the slot of the unacknowledged packet that belongs to the same LATEST_VALUE stream as the packet; there is at most one because every packet of a stream replaces the one before.
+ */
+void SendWindow::supersede(std::shared_ptr<Packet> &packet)
+{
+    for (size_t i = 0; i < NET::SEND_WINDOW_SIZE; i++)
+    {
+        Entry &entry = this->slots[i];
+
+        if (entry.packet != nullptr && entry.packet->getDeliveryClass() == NET::DeliveryClass::LATEST_VALUE && entry.packet->getStream() == packet->getStream())
+        {
+            this->release(entry);
+            this->supersededPackets++;
+            return;
+        }
+    }
+}
+
+void SendWindow::release(Entry &entry)
+{
+    if (entry.packet != nullptr)
+        this->inFlight--;
+
+    entry.packet = nullptr;
+    entry.transmissions = 0;
+    entry.resendRequested = false;
+}
\ No newline at end of file
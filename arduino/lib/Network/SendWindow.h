@@ -0,0 +1,56 @@
+#ifndef SEND_WINDOW_H
+#define SEND_WINDOW_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include <memory>
+
+#include "Packet.h"
+#include "Config.h"
+
+//fixed array of RELIABLE and LATEST_VALUE packets that were sent but not yet acknowledged; a packet with sequence n is stored at n % NET::SEND_WINDOW_SIZE
+class SendWindow {
+    public:
+        SendWindow(NET::SendWindowPolicy policy);
+
+        bool reserve(std::shared_ptr<Packet> &packet, uint16_t sequence);
+        void insert(std::shared_ptr<Packet> packet, unsigned long now);
+        bool acknowledge(uint16_t sequence, unsigned long now, unsigned long &roundTripTime);
+        bool acknowledgeUpTo(uint16_t sequence, unsigned long now, unsigned long &roundTripTime);
+        std::shared_ptr<Packet> get(uint16_t sequence);
+        void requestResend(uint16_t sequence);
+        void requestFastRetransmit(uint16_t sequence);
+        bool collectRetransmissions(unsigned long now, unsigned long timeout, std::vector<std::shared_ptr<Packet>> &output);
+        unsigned long getTimeToRetransmission(unsigned long now, unsigned long timeout);
+        void clear();
+
+        bool isFull();
+        size_t getInFlight();
+        void getStatistics(JsonObject &json);
+
+    private:
+        struct Entry {
+            std::shared_ptr<Packet> packet;
+            unsigned long sentAt;//millis() of the last transmission
+            uint8_t transmissions;
+            bool resendRequested;//the client reported the packet as missing
+        };
+
+        Entry slots[NET::SEND_WINDOW_SIZE];
+        size_t inFlight;//occupied slots
+        NET::SendWindowPolicy policy;
+
+        unsigned long evictedPackets;
+        unsigned long blockedPackets;
+        unsigned long retransmittedPackets;
+        unsigned long expiredPackets;
+        unsigned long supersededPackets;
+
+        Entry* find(uint16_t sequence);
+        bool isEvictable(std::shared_ptr<Packet> &packet);
+        void supersede(std::shared_ptr<Packet> &packet);
+        void release(Entry &entry);
+};
+
+#endif
@@ -1,90 +1,104 @@
 #include <Arduino.h>
+#include <vector>
 #include <memory>
 
 #include "SerialProtocol.h"
 #include "Config.h"
 #include "Logger.h"
 #include "Packet.h"
+#include "Cobs.h"
 #include "Definitions.h"
 
-SerialProtocol::SerialProtocol() : ProtocolBase(NET::SERIAL_NAME, NET::MAX_BUFFER_SIZE) {}
+SerialProtocol::SerialProtocol() : ProtocolBase(NET::SERIAL_NAME, NET::MAX_BUFFER_SIZE), cobsFraming(NET::DEFAULT_SERIAL_FRAMING == NET::FRAMING_COBS), rxFrameOverflow(false)
+{
+    this->rxFrame.reserve(Cobs::maxEncodedSize(NET::MAX_BUFFER_SIZE));
+}
 
 void SerialProtocol::init()
 {
     Serial.begin(BAUDRATE);
+    // the callback runs in the uart event task when bytes were received, so the main loop can sleep until then
+    Serial.onReceive([this]() { this->signalData(); });
     this->connected = true;
 }
 
 void SerialProtocol::destroy()
 {
+    Serial.onReceive(nullptr);
     Serial.end();
     this->connected = false;
+    this->parser.reset();
 }
 
 /**
- * @note we add -1 to the dataSize because we do not want to send the packet with the terminating \x00 byte. we can not add it before because we need to consider the terminating char while handling it in the packet class.
+ * @note the packet is serialised into the tx buffer of the protocol without the terminating \x00 byte, so there is no allocation per packet. with cobs framing, the packet is encoded into the tx frame, which only grows, and is followed by the delimiter.
  */
 void SerialProtocol::writePacket(std::shared_ptr<Packet> packet)
 {
     if (!this->connected)
         return;
 
-    uint8_t *data = packet->serialize();
-    size_t dataSize = packet->getPacketSize() - 1;
+    if (!this->cobsFraming)
+    {
+        size_t dataSize = this->serializeToTxBuffer(packet);
+        Serial.write(this->getTxBuffer(), dataSize);
+        return;
+    }
+
+    size_t frameSize = this->encodeFrame(packet, 0);
+    Serial.write(this->txFrame.data(), frameSize);
+}
+
+/**
+ * @brief writes the packets with a single Serial.write: raw packets are serialised back to back, cobs frames are encoded one after the other into the tx frame.
+ */
+void SerialProtocol::writePackets(std::vector<std::shared_ptr<Packet>> &packets)
+{
+    if (!this->connected)
+        return;
+
+    if (!this->cobsFraming)
+    {
+        size_t dataSize = this->serializeToTxBuffer(packets);
+        Serial.write(this->getTxBuffer(), dataSize);
+        return;
+    }
+
+    size_t frameSize = 0;
+    for (std::shared_ptr<Packet> &packet : packets)
+    {
+        frameSize = this->encodeFrame(packet, frameSize);
+    }
 
-    Serial.write(data, dataSize);
-    
-    delete[] data;
+    Serial.write(this->txFrame.data(), frameSize);
 }
 
 /**
- * @brief Read data from serial port when available. The expected packet starts with a method flag (one byte) defined in Config.h. Therefore we read bytes from serial until we recognise one of the flags. Then we create the header array with size 9. At index 8, we can read the size of the payload directly following the header.
+ * @brief Read the data that is available on the serial port in chunks and feed it to the packet parser of the protocol. The parser keeps a partially received packet between calls, so we never wait for the rest of a packet and never read a byte twice. We stop reading as soon as a packet is complete so that the remaining bytes stay in the serial buffer until the next call.
+ * @return the next complete packet; nullptr if no packet is complete yet
  */
 std::shared_ptr<Packet> SerialProtocol::readPacket()
 {
     if (!this->connected)
         return nullptr;
     unsigned long startTime = millis();
+    uint8_t chunk[NET::PARSER_CHUNK_SIZE];
 
-    while (Serial.available() > 0)
+    while (!this->parser.hasPacket() && Serial.available() > 0)
     {
         // timeout requesting data from serial to avoid unresponsive microcontroller
         if (millis() - startTime >= NET::TIMEOUT_DEFAULT)
-            return nullptr;
-
-        uint8_t flag = Serial.peek();
-
-        // Check if the read byte is the start flag
-        if (Packet::verifyFlag(flag))
-        {
-            // Create the header array and set the first byte to the flag
-            uint8_t header[NET::HEADER::SIZE];
-
-            if (Serial.available() < NET::HEADER::SIZE)
-                return nullptr;
-            // Read the rest of the header
-            Serial.readBytes(header, NET::HEADER::SIZE);
-            // Determine the payload size from the header
-            std::shared_ptr<Packet> packet = std::make_shared<Packet>();
-            packet->deserializeHeader(header);
+            break;
 
-            uint16_t payloadSize = packet->getPayloadSize();
+        size_t chunkSize = Serial.readBytes(chunk, min((size_t)Serial.available(), sizeof(chunk)));
 
-            if (Serial.available() < payloadSize)
-                return nullptr;
-
-            // Allocate the payload buffer and read the payload
-            char payload[payloadSize + 1];
-            Serial.readBytes(payload, payloadSize);
-            payload[payloadSize] = '\0'; // Null-terminate the payload
-
-            packet->deserializePayload(payload);
-
-            return std::move(packet);
-        }
+        if (this->cobsFraming)
+            this->feedFrames(chunk, chunkSize);
+        else
+            this->parser.feed(chunk, chunkSize);
     }
 
-    return nullptr; // no data is available
+    return this->parser.next();
 }
 
 bool SerialProtocol::checkConnection()
@@ -99,4 +113,77 @@ bool SerialProtocol::checkConnection()
     }
 
     return this->connected;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief selects how packets are delimited on the serial port. the framing of the other side must be changed at the same time, therefore it is negotiated with the command SERIAL_FRAMING_SELECT whose response is already sent with the new framing. bytes of a partially received packet are dropped.
+ * @param framing NET::FRAMING_RAW or NET::FRAMING_COBS
+ * @return false if the framing is unknown
+ */
+bool SerialProtocol::setFraming(String framing)
+{
+    if (framing != NET::FRAMING_RAW && framing != NET::FRAMING_COBS)
+        return false;
+
+    this->cobsFraming = framing == NET::FRAMING_COBS;
+    this->rxFrame.clear();
+    this->rxFrameOverflow = false;
+    this->parser.discardPartial();
+
+    return true;
+}
+
+String SerialProtocol::getFraming()
+{
+    return this->cobsFraming ? NET::FRAMING_COBS : NET::FRAMING_RAW;
+}
+
+/**
+ * @brief encodes the packet with cobs into the tx frame at offset and appends the delimiter; the tx frame only grows
+ * @return offset after the delimiter
+ */
+size_t SerialProtocol::encodeFrame(std::shared_ptr<Packet> &packet, size_t offset)
+{
+    size_t dataSize = this->serializeToTxBuffer(packet);
+
+    size_t frameSize = offset + Cobs::maxEncodedSize(dataSize) + 1;
+    if (this->txFrame.size() < frameSize)
+        this->txFrame.resize(frameSize);
+
+    offset += Cobs::encode(this->getTxBuffer(), dataSize, this->txFrame.data() + offset);
+    this->txFrame[offset++] = Cobs::DELIMITER;
+
+    return offset;
+}
+
+/**
+ * @brief collects bytes until the delimiter, decodes the frame in place and feeds exactly one packet to the parser. a corrupted or oversized frame is dropped as a whole and the next frame starts after the next delimiter, so a lost byte never costs more than the packet it belonged to.
+ */
+void SerialProtocol::feedFrames(const uint8_t *data, size_t length)
+{
+    static const size_t maxFrameSize = Cobs::maxEncodedSize(NET::HEADER::EXTENDED_SIZE + NET::PARSER_MAX_PAYLOAD_SIZE);
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (data[i] != Cobs::DELIMITER)
+        {
+            if (this->rxFrame.size() < maxFrameSize)
+                this->rxFrame.push_back(data[i]);
+            else
+                this->rxFrameOverflow = true;
+
+            continue;
+        }
+
+        size_t decodedSize = this->rxFrameOverflow ? 0 : Cobs::decode(this->rxFrame.data(), this->rxFrame.size(), this->rxFrame.data());
+
+        if (decodedSize > 0)
+        {
+            this->parser.discardPartial();
+            this->parser.feed(this->rxFrame.data(), decodedSize);
+        }
+
+        this->rxFrame.clear();
+        this->rxFrameOverflow = false;
+    }
+}
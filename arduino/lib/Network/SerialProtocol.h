@@ -1,6 +1,8 @@
 #ifndef SERIAL_PROTOCOL_H
 #define SERIAL_PROTOCOL_H
 
+#include <Arduino.h>
+#include <vector>
 #include <memory>
 
 #include "ProtocolBase.h"
@@ -13,8 +15,21 @@ class SerialProtocol: public ProtocolBase {
         void init() override;
         void destroy() override;
         void writePacket(std::shared_ptr<Packet> packet) override;
+        void writePackets(std::vector<std::shared_ptr<Packet>> &packets) override;
         std::shared_ptr<Packet> readPacket() override;
         bool checkConnection() override;
+
+        bool setFraming(String framing);
+        String getFraming();
+
+    private:
+        bool cobsFraming;
+        std::vector<uint8_t> rxFrame;
+        bool rxFrameOverflow;
+        std::vector<uint8_t> txFrame;
+
+        void feedFrames(const uint8_t* data, size_t length);
+        size_t encodeFrame(std::shared_ptr<Packet> &packet, size_t offset);
 };
 
 #endif
\ No newline at end of file
@@ -36,12 +36,13 @@ void WifiProtocol::init()
 void WifiProtocol::destroy()
 {
     WiFi.disconnect(true);
+    this->parser.reset();
     // connected is handled by the event callbacks
 }
 
 /**
  * @brief writes a packet with wifi udp. after checking the connection status, we create a udp header with the clients credentials. We write the data as uint8_t because the header is in binary and sometimes contains 0x00 values in the sequence/payloadSize/checksum field which would cut the string because 0x00 cuts a C-String.
- * @note we add -1 to the dataSize because we do not want to send the packet with the terminating \x00 byte. we can not add it before because we need to consider the terminating char while handling it in the packet class.
+ * @note the packet is serialised into the tx buffer of the protocol without the terminating \x00 byte, so there is no allocation per packet.
  */
 void WifiProtocol::writePacket(std::shared_ptr<Packet> packet)
 {
@@ -53,17 +54,14 @@ void WifiProtocol::writePacket(std::shared_ptr<Packet> packet)
 
     this->udp.beginPacket(this->credentials.clientIp.c_str(), this->credentials.clientPort);
 
-    uint8_t *data = packet->serialize();
-    size_t dataSize = packet->getPacketSize() - 1;
-    this->udp.write(data, dataSize);
+    size_t dataSize = this->serializeToTxBuffer(packet);
+    this->udp.write(this->getTxBuffer(), dataSize);
     this->udp.endPacket();
-    
-    delete[] data;
 }
 
 /**
- * @brief in the first step we check if there is a connection. we implement a timer which timeouts the whileloop - the value for it can be found in Config.h. Next we check if udp has data in the buffer. We start be checking the first byte for the method flag. as long as it is not the method flag, we drop the byte and look at the next byte. if we found the correct method flag (can also be foundin config.h) we check if the bytes available are bigger than our headerSize (can be found in config.h). we read the header into a integer array as especially look at byte 9 and 10 because they make a uint16_t integer telling the size of the payload which directly follows the 10th byte of the header. there we also check if the udp buffer has enough data to read the payload. after that we deserliased it with the packet class and return it.
- * @return a packet that deserialised the packet from the network; can be nullptr
+ * @brief in the first step we check if there is a connection. we implement a timer which timeouts the whileloop - the value for it can be found in Config.h. Every datagram is read completely in chunks and fed to the packet parser of the protocol because parsePacket() discards the unread bytes of the previous datagram. The parser finds the method flag, the header and the payload and keeps a packet that is split across datagrams until the rest arrives.
+ * @return the next complete packet; can be nullptr
  */
 std::shared_ptr<Packet> WifiProtocol::readPacket()
 {
@@ -71,45 +69,21 @@ std::shared_ptr<Packet> WifiProtocol::readPacket()
         return nullptr;
 
     unsigned long startTime = millis();
-    size_t packetSize = this->udp.parsePacket();
+    uint8_t chunk[NET::PARSER_CHUNK_SIZE];
 
-    while (this->udp.available() > 0)
+    while (!this->parser.hasPacket() && this->udp.parsePacket() > 0)
     {
-        if (millis() - startTime >= NET::TIMEOUT_DEFAULT)
-            return nullptr;
-
-        uint8_t flag = this->udp.peek();
-        if (!Packet::verifyFlag(flag))
+        while (this->udp.available() > 0)
         {
-            this->udp.read(); // discard the bytes that are not yet the flag of our packet
+            size_t chunkSize = this->udp.read(chunk, sizeof(chunk));
+            this->parser.feed(chunk, chunkSize);
         }
-        else
-        {
-            if (this->udp.available() < NET::HEADER::SIZE)
-                return nullptr;
-
-            uint8_t header[NET::HEADER::SIZE];
-
-            this->udp.readBytes(header, NET::HEADER::SIZE);
-
-            std::shared_ptr<Packet> packet = std::make_shared<Packet>();
-            packet->deserializeHeader(header);
-            uint16_t payloadSize = packet->getPayloadSize();
-
-            if (this->udp.available() < payloadSize)
-                return nullptr;
-
-            char payload[payloadSize + 1];
-            this->udp.readBytes(payload, payloadSize);
-            payload[payloadSize] = '\0';
 
-            packet->deserializePayload(payload);
-
-            return std::move(packet);
-        }
+        if (millis() - startTime >= NET::TIMEOUT_DEFAULT)
+            break;
     }
 
-    return nullptr;
+    return this->parser.next();
 }
 
 /**
@@ -120,3 +94,11 @@ bool WifiProtocol::checkConnection()
 {
     return WiFi.status() == WL_CONNECTED || this->connected;
 }
+
+/**
+ * @brief WiFiUDP has no callback for received datagrams, therefore the socket is polled every NET::UDP_POLL_INTERVAL milli seconds while the protocol is active
+ */
+unsigned long WifiProtocol::getPollInterval()
+{
+    return NET::UDP_POLL_INTERVAL;
+}
@@ -18,6 +18,7 @@ class WifiProtocol: public ProtocolBase, public WiFiProfile {
         void writePacket(std::shared_ptr<Packet> packet) override;
         std::shared_ptr<Packet> readPacket() override;
         bool checkConnection() override;
+        unsigned long getPollInterval() override;
 
     private:
         WiFiUDP udp;
@@ -10,6 +10,7 @@ struct SensorCapabilities {
     bool includeSequence; //sensors values include sequence
     unsigned long sampleRate; //the interval at which sensor data is read
     bool dataOnStateChange;//only send data when the state of the sensors changes to the last time
+    bool binaryEncoding;//send data as fixed-layout little endian fields instead of json
 };
 
 struct ActuatorCapabilities {
@@ -20,6 +21,9 @@ struct DeviceCapabilities {//these are the devices general settings for a record
     unsigned long duration; //0 forever, 1+ keep sending data for x seconds
     unsigned long maxSamples; //samples data until the maxSamples value is reached. compares the with sensors value with the highest sample rate
     int delay; //seconds after using the start command until recording actually starts; example: can be used to move from the computer to the recording location where you have more freedom to perform gestures.
+    unsigned long batchMaxLatency; //0 sends every sample in its own packet, 1+ collects samples in a batch packet for at most x milli seconds
+    unsigned long batchMaxSamples; //a batch packet is sent when it holds this many samples, even if batchMaxLatency has not passed yet
+    uint8_t fecGroupSize; //0 disables forward error correction, 2+ sends a parity packet after this many data packets
 };
 
 class ISensorCapabilities {
@@ -43,4 +47,9 @@ class IDeviceCapabilities {
         virtual void resetCapabilities() = 0;
 };
 
+class INetworkCapabilities {
+    public:
+        virtual void setForwardErrorCorrection(uint8_t groupSize) = 0;
+};
+
 #endif
\ No newline at end of file
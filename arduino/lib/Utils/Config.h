@@ -26,6 +26,8 @@ namespace CMD {
     const String SELECT_SERIAL = "SELECT_SERIAL";
     const String ACKNOWLEDGEMENT_ENABLE = "ACKNOWLEDGEMENT_ENABLE";
     const String ACKNOWLEDGEMENT_DISABLE = "ACKNOWLEDGEMENT_DISABLE";
+    const String SERIAL_FRAMING_SELECT = "SERIAL_FRAMING_SELECT";
+    const String SEQUENCE_MODE_SELECT = "SEQUENCE_MODE_SELECT";
 }
 
 namespace CUSTOM_CMD {
@@ -60,22 +62,69 @@ namespace NET {
     const String SERIAL_NAME = "SERIAL";
     const String WIFI_NAME = "WIFI";
     const String BLE_NAME = "BLE";
+    const String LOSSY_LINK_NAME = "LOSSY";
     const bool IS_CONNECTED_DEFAULT = false;
     const int TIME_TO_CONNECT_PROTOCOL = 500;
     const int TIMEOUT_WIRELESS_UPGRADE = 1000;
     const int TIMEOUT_DEFAULT = 50;
-    const size_t OUT_OF_ORDER_PACKET_MAX_SIZE = 5;
-    const uint16_t SEQUENCE_MAX_NUMBER_SIZE = std::numeric_limits<uint16_t>::max();
+    const size_t REORDER_BUFFER_SIZE = 32;//sequences after the expected one that can be stored; size of the occupancy bitmap
     const bool SEND_ACK_PACKETS = false;
     const unsigned int HEARTBEAT_INTERVAL = 1000;
+    const unsigned long INBOUND_BUDGET_US = 2000;//micro seconds per iteration in which received packets are read and processed; the rest waits for the next iteration so that a burst can not stall the sensors
+    const unsigned long OUTBOUND_BUDGET_US = 3000;//micro seconds per iteration in which the output queue is written; checked after each batch, so one batch is always written
+    const size_t WRITE_BATCH_SIZE = 8;//packets that are handed to the protocol with one writePackets call
+    const unsigned long UDP_POLL_INTERVAL = 5;//milli seconds; WiFiUDP has no receive callback, so the socket is polled while the WiFi protocol is active
     const int BLE_ATT_OVERHEAD = 3;
     const int BLE_EXPECTED_MTU = 256;
     const int BLE_CHUNK_TIMEOUT = 5;
+    const size_t PACKET_POOL_SIZE = 32;//number of packets that can exist at the same time without using the heap
+    const size_t PACKET_POOL_PAYLOAD_SIZE = MAX_BUFFER_SIZE;//bytes per payload slot including \0, so that a full batch fits; larger payloads are allocated on the heap
+    const uint16_t PARSER_MAX_PAYLOAD_SIZE = 8192;//bytes; larger payload sizes in a header are treated as corrupted
+    const size_t PARSER_CHUNK_SIZE = 64;//bytes that are read from the transport at once and fed to the parser
+    const String FRAMING_RAW = "raw";//packets are written back to back; the parser searches for the method flag
+    const String FRAMING_COBS = "cobs";//every packet is COBS encoded and followed by a 0x00 delimiter
+    const String DEFAULT_SERIAL_FRAMING = FRAMING_RAW;
+    const String SEQUENCE_SHORT = "short";//16 bit sequence in the header; wraps after 65536 packets
+    const String SEQUENCE_EXTENDED = "extended";//the header is followed by the upper 16 bits of a 32 bit sequence
+    const String DEFAULT_SEQUENCE_MODE = SEQUENCE_SHORT;
+    enum class SendWindowPolicy { BLOCK, DROP_OLDEST_DATA };//what happens with the next packet when its slot in the send window is taken
+    /* how the integrity layer treats a packet when ACK packets are enabled. RELIABLE packets are kept in the send window until they are acknowledged. BEST_EFFORT packets get a sequence but are never kept or retransmitted. LATEST_VALUE packets are kept like RELIABLE ones, but a newer packet of the same stream replaces the unacknowledged older one, so only the latest state is retransmitted. */
+    enum class DeliveryClass { RELIABLE, BEST_EFFORT, LATEST_VALUE };
+    const size_t SEND_WINDOW_SIZE = 16;//unacknowledged packets that are kept for a resend; must be a power of two
+    static_assert(REORDER_BUFFER_SIZE >= SEND_WINDOW_SIZE, "the reorder buffer must hold every packet that can be in flight behind a missing one, otherwise a retransmission arrives after its gap was given up");
+    const SendWindowPolicy SEND_WINDOW_POLICY = SendWindowPolicy::DROP_OLDEST_DATA;
+    const unsigned long RTO_INITIAL = 1000;//milli seconds; retransmission timeout before the first round trip time is measured
+    const unsigned long RTO_MIN = 200;//milli seconds
+    const unsigned long RTO_MAX = 8000;//milli seconds
+    const unsigned long ACK_DELAY = 20;//milli seconds a received packet may wait for its ACK so that one ACK confirms several packets
+    const uint16_t ACK_EVERY = 2;//received packets after which an ACK is sent without waiting for ACK_DELAY
+    const uint8_t SACK_BITS = REORDER_BUFFER_SIZE;//packets after the next expected sequence that are described by the bitmap of an ACK
+    const size_t ACK_PAYLOAD_SIZE = 6;//binary ACK, big endian: [next expected sequence: uint16][sack bitmap: uint32]
+    const size_t HEARTBEAT_PAYLOAD_SIZE = 4;//binary heartbeat, big endian: [uptime in milli seconds: uint32]
+    const uint8_t MAX_TRANSMISSIONS = 5;//a packet that is not acknowledged after this many transmissions is removed from the send window
+    const uint8_t FEC_MAX_GROUP_SIZE = 16;//data packets that can be protected by one parity packet
+    const size_t FEC_PARITY_OVERHEAD = 1 + 2 * FEC_MAX_GROUP_SIZE + 3;//bytes of a parity payload in front of the payload parity: count, sequences, method and length parity
+    const size_t OUTPUT_QUEUE_CAPACITY = 24;//data packets in the output queue after which the sensors must wait; the sensors also wait while the packet pool is exhausted (see PacketPool::getRoom)
+    enum class QueueDropPolicy { DROP_NEWEST, DROP_OLDEST };//what happens with a packet that is added to a full class of the output queue
+    const size_t OUTPUT_QUEUE_CONTROL_CAPACITY = 8;//ACK and HEARTBEAT packets; an older one is dropped because the newer one carries the same information
+    const size_t OUTPUT_QUEUE_RESPONSE_CAPACITY = 16;//responses to commands (INFO); a new one is dropped so that the responses that are queued keep their order
+    const size_t OUTPUT_QUEUE_ERROR_CAPACITY = 16;//error logs; a new one is dropped because the first error is the one that explains the others
+    const size_t OUTPUT_QUEUE_DEBUG_CAPACITY = 16;//debug logs; an older one is dropped
+    //default impairments of the LossyLink in both directions (see LossyLinkImpairments); only used in builds with LOSSY_LINK=1 and by the host harness
+    const float LOSSY_LINK_LOSS = 0.05f;//probability that a packet is dropped
+    const float LOSSY_LINK_DUPLICATE = 0.01f;//probability that a packet is delivered twice
+    const float LOSSY_LINK_REORDER = 0.02f;//probability that a packet is delivered after the next one
+    const float LOSSY_LINK_CORRUPT = 0.01f;//probability that one payload byte is flipped so that the checksum fails
+    const unsigned long LOSSY_LINK_LATENCY = 20;//milli seconds
+    const unsigned long LOSSY_LINK_JITTER = 10;//milli seconds added at random to the latency
+    const uint32_t LOSSY_LINK_SEED = 1;//the same seed produces the same impairments for the same packets
 
     namespace HEADER {
         const size_t SIZE = 10;
+        const size_t EXTENDED_SIZE = 12;//header size in the extended sequence mode
         const unsigned int PAYLOADSIZE_POSITION = 8;
-        //reserve the 6 characters in ASCII table starting with 0x20 and ending with 0x26 as the beginning byte of our packets
+        const unsigned int SEQUENCE_HIGH_POSITION = 10;//upper 16 bits of the sequence in the extended sequence mode
+        //reserve the 9 characters in ASCII table starting with 0x20 and ending with 0x28 as the beginning byte of our packets
         const uint8_t METHOD_ACKNOWLEDGEMENT = 0x20; //SP
         const uint8_t METHOD_DATA = 0x21; //!
         const uint8_t METHOD_COMMAND = 0x22; //"
@@ -83,6 +132,8 @@ namespace NET {
         const uint8_t METHOD_DEBUG = 0x24; //$
         const uint8_t METHOD_INFO = 0x25; //%
         const uint8_t METHOD_ERROR = 0x26; //&
+        const uint8_t METHOD_BATCH = 0x27; //'
+        const uint8_t METHOD_PARITY = 0x28; //(
     }
 }
 
@@ -91,11 +142,25 @@ namespace DEVICE {
     const unsigned long MAX_SAMPLES = 0;
     const int DELAY = 0;//milli seconds
     const bool DEFAULT_INCLUDE = true;//if a sensor/actuator is enabled
+    const unsigned long BATCH_MAX_LATENCY = 0;//milli seconds; 0 disables batching
+    const unsigned long BATCH_MAX_SAMPLES = 10;
+    const size_t BATCH_MAX_PAYLOAD_SIZE = NET::MAX_BUFFER_SIZE - NET::HEADER::EXTENDED_SIZE - NET::FEC_PARITY_OVERHEAD;//464 bytes; keeps a batch packet and the parity packet that protects it within NET::MAX_BUFFER_SIZE
+    const uint8_t FEC_GROUP_SIZE = 0;//data packets per parity packet; 0 disables forward error correction
+    static_assert(BATCH_MAX_PAYLOAD_SIZE + 1 <= NET::PACKET_POOL_PAYLOAD_SIZE, "a full batch payload must fit into a payload slot of the packet pool");
 }
 
 namespace MC {
     const size_t MC_NAME_LENGTH = 4;
-    const int32_t LOOP_WAIT_TIME_DEFAULT = 5;
+    const size_t COMMAND_ARENA_SIZE = 4096;//bytes for the json document of the received command; a larger command uses the heap for the rest
+    const unsigned long MAX_IDLE_TIME = 100;//milli seconds the main loop or a task sleeps at most when no deadline and no event is due
+    //tasks of the dual core build (DUAL_CORE=1); the network task shares core 0 with the WiFi/BLE stack, the sampling task has core 1 where the arduino loop runs otherwise
+    const size_t SAMPLE_RING_SIZE = 32;//sensor packets between the sampling and the network task; must be a power of two
+    const int NETWORK_TASK_CORE = 0;
+    const int SAMPLING_TASK_CORE = 1;
+    const uint32_t NETWORK_TASK_STACK_SIZE = 8192;//bytes
+    const uint32_t SAMPLING_TASK_STACK_SIZE = 8192;//bytes
+    const unsigned int NETWORK_TASK_PRIORITY = 2;
+    const unsigned int SAMPLING_TASK_PRIORITY = 2;
 }
 
 namespace SENS {
@@ -103,6 +168,9 @@ namespace SENS {
     const bool DEFAULT_INCLUDE_TIMESTAMP = false;
     const int DEFAULT_SAMPLE_RATE = 10;
     const bool DEFAULT_DATA_ON_CHANGE = false;
+    const bool DEFAULT_BINARY_ENCODING = false;
+    const String ENCODING_JSON = "json";
+    const String ENCODING_BINARY = "binary";
 }
 
 namespace ACT {
@@ -115,6 +183,7 @@ namespace ACT {
 
 namespace UTIL {
     const String REPLACE_STRING = "%%";
+    const unsigned long NO_DEADLINE = (unsigned long)-1;//time to the next event if nothing is scheduled
     #if DEBUG_MODE
         const bool LOGGER_DEBUGGING_DEFAULT = true; 
     #else
@@ -22,6 +22,14 @@
 #define DEBUG_MODE 1
 #endif
 
+#ifndef DUAL_CORE
+#define DUAL_CORE 1 //1 runs the sensors and the network in two tasks on the two cores of the ESP32; 0 runs everything in the arduino loop
+#endif
+
+#ifndef LOSSY_LINK
+#define LOSSY_LINK 0 //1 routes the current protocol through the LossyLink that drops, duplicates, reorders, corrupts and delays packets
+#endif
+
 #ifndef WIRELESS_MODE
 #define WIRELESS_MODE BLE
 #endif
@@ -12,7 +12,7 @@
 #include "PacketRelay.h"
 #include "Definitions.h"
 
-DeviceManager::DeviceManager(BoardBase *board) : identity(MC_NAME), board(board), startTime(0), isRecording(false)
+DeviceManager::DeviceManager(BoardBase *board) : identity(MC_NAME), board(board), startTime(0), droppedSamples(0), isRecording(false), networkCapabilities(nullptr)
 {
     this->deviceCapabilities = DeviceCapabilities();
     this->resetCapabilities();
@@ -50,6 +50,14 @@ ActuatorBase *DeviceManager::getActuator(const String &id)
     return nullptr;
 }
 
+/**
+ * @brief the networkmanager applies the network settings of a record, e.g. the forward error correction
+ */
+void DeviceManager::setNetworkCapabilities(INetworkCapabilities *networkCapabilities)
+{
+    this->networkCapabilities = networkCapabilities;
+}
+
 void DeviceManager::updateSensors()
 {
     this->board->update();
@@ -107,7 +115,12 @@ void DeviceManager::isRecordComplete()
     }
 }
 
-std::vector<std::shared_ptr<Packet>> DeviceManager::readSensors()
+/**
+ * @brief reads the sensors that are due and creates at most capacity packets. when the network can not take more packets, samples are added to the batch without flushing it (the batch grows up to DEVICE::BATCH_MAX_PAYLOAD_SIZE) and all other samples are skipped, a sample that can not go into the batch before its sensor is read. a skipped sensor is read again at its next interval, so its rate is decimated to what the transport can handle instead of the output queue growing until the heap runs out.
+ * @param capacity number of packets the networkmanager (or the sample ring) and the packet pool can take now, see NetworkManager::getSendCapacity and PacketPool::getRoom
+ * @return packets with sensor data
+ */
+std::vector<std::shared_ptr<Packet>> DeviceManager::readSensors(size_t capacity)
 {
     std::vector<std::shared_ptr<Packet>> output;
 
@@ -120,22 +133,96 @@ std::vector<std::shared_ptr<Packet>> DeviceManager::readSensors()
         if (!sensor->isTimeToRun())
             continue;        
 
-        String data = sensor->readData();
+        NET::DeliveryClass deliveryClass = sensor->getDeliveryClass();
+        bool batchable = this->batch.isEnabled() && deliveryClass == NET::DeliveryClass::BEST_EFFORT;
+
+        // without capacity, a sample that can not wait in the batch is skipped before the sensor is read
+        if (output.size() >= capacity && !batchable)
+        {
+            this->droppedSamples++;
+            continue;
+        }
+
+        std::vector<uint8_t> data = sensor->readData();
 
         if (!sensor->hasStateChanged(data))
             continue;        
 
+        // samples that do not fit into an empty batch are sent in their own packet, and so are states which must not share a best-effort batch
+        bool batched = batchable && data.size() + sizeof(uint16_t) <= DEVICE::BATCH_MAX_PAYLOAD_SIZE;
+
+        // a batched sample only needs a packet when the batch must be flushed to make room for it
+        if (output.size() >= capacity && (!batched || !this->batch.fits(data.size())))
+        {
+            this->droppedSamples++;
+            continue;
+        }
+
         this->sampleCount++; // TODO: for all samples?    
-        std::shared_ptr<Packet> packet = std::make_shared<Packet>();
+
+        if (batched)
+        {
+            if (!this->batch.fits(data.size()))
+                output.push_back(this->batch.flush());
+
+            this->batch.add(data, millis());
+
+            if (this->batch.isFull() && output.size() < capacity)
+                output.push_back(this->batch.flush());
+
+            continue;
+        }
+
+        std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
         packet->setMethod(NET::HEADER::METHOD_DATA);
-        packet->setPayload(data.c_str());
+        packet->setPayload(data.data(), data.size());
+        // the sensor object identifies the stream of a LATEST_VALUE packet
+        packet->setDeliveryClass(deliveryClass, (uint32_t)(uintptr_t)sensor);
 
         output.push_back(std::move(packet));
     }
 
+    // the latency bound is checked every iteration, also when no sensor was due
+    if (this->batch.isDue(millis()) && output.size() < capacity)
+        output.push_back(this->batch.flush());
+
     return output;
 }
 
+/**
+ * @brief tells the main loop how long it may sleep until the record starts after its delay, a sensor is due, the batch reaches its latency bound or the record duration is over.
+ * @return milli seconds until the next sample; UTIL::NO_DEADLINE if no record is running
+ */
+unsigned long DeviceManager::getTimeToNextSample()
+{
+    if (!this->isRecording)
+        return UTIL::NO_DEADLINE;
+
+    unsigned long now = millis();
+    unsigned long elapsed = now - this->startTime;
+    unsigned long startDelay = this->deviceCapabilities.delay;
+
+    if (elapsed < startDelay)
+        return startDelay - elapsed;
+
+    unsigned long time = UTIL::NO_DEADLINE;
+
+    // isRecordComplete stops the record one milli second after the duration
+    if (this->capabilities.duration > 0)
+        time = elapsed > this->capabilities.duration ? 0 : this->capabilities.duration + 1 - elapsed;
+
+    for (auto it : this->sensors)
+    {
+        if (it.second->isEnabled())
+            time = min(time, it.second->getTimeToRun(now));
+    }
+
+    // a due batch is still waiting for room in the network; it is tried again after a milli second instead of in a busy loop
+    time = min(time, this->batch.isDue(now) ? 1UL : this->batch.getTimeToDue(now));
+
+    return time;
+}
+
 /**
  * @brief identifies the microcontroller by sending a package which includes the feedback name and the identity of the microcontroller (this is already included in the packet header, therefore we dont include it in the payload)
  * @note used in commandmanager
@@ -188,6 +275,9 @@ void DeviceManager::readCapabilities()
     doc["duration"] = this->capabilities.duration;
     doc["max_samples"] = this->capabilities.maxSamples;
     doc["delay"] = this->capabilities.delay;
+    doc["batch_max_latency"] = this->deviceCapabilities.batchMaxLatency;
+    doc["batch_max_samples"] = this->deviceCapabilities.batchMaxSamples;
+    doc["fec_group"] = this->deviceCapabilities.fecGroupSize;
 
     JsonArray docSensors = doc["sensors"].to<JsonArray>();
     for (auto &sensor : this->sensors)
@@ -201,6 +291,7 @@ void DeviceManager::readCapabilities()
         s["include_sequence"] = sc->includeSequence;
         s["sample_rate"] = sc->sampleRate;
         s["data_on_state_change"] = sc->dataOnStateChange;
+        s["encoding"] = sc->binaryEncoding ? SENS::ENCODING_BINARY : SENS::ENCODING_JSON;
 
         JsonObject jObject = s["model_data"].to<JsonObject>();
         sensor.second->getModelDefinition(jObject);
@@ -241,6 +332,12 @@ void DeviceManager::createCapabilities(JsonDocument *json)
         this->deviceCapabilities.delay = data["delay"].as<int>();
         this->deviceCapabilities.duration = data["duration"].as<unsigned long>();
         this->deviceCapabilities.maxSamples = data["max_samples"].as<unsigned long>();
+        this->deviceCapabilities.batchMaxLatency = data["batch_max_latency"] | DEVICE::BATCH_MAX_LATENCY;
+        this->deviceCapabilities.batchMaxSamples = data["batch_max_samples"] | DEVICE::BATCH_MAX_SAMPLES;
+        this->batch.configure(this->deviceCapabilities.batchMaxLatency, this->deviceCapabilities.batchMaxSamples);
+        this->deviceCapabilities.fecGroupSize = min(data["fec_group"] | DEVICE::FEC_GROUP_SIZE, NET::FEC_MAX_GROUP_SIZE);
+        if (this->networkCapabilities != nullptr)
+            this->networkCapabilities->setForwardErrorCorrection(this->deviceCapabilities.fecGroupSize);
         bool includeTimestamp = data["include_timestamp"].as<bool>();
         bool includeSequence = data["include_sequence"].as<bool>();
 
@@ -258,6 +355,7 @@ void DeviceManager::createCapabilities(JsonDocument *json)
             senCap.includeSequence = includeSequence;
             senCap.sampleRate = item["sample_rate"].as<unsigned long>();
             senCap.dataOnStateChange = item["data_on_state_change"].as<bool>();
+            senCap.binaryEncoding = item["encoding"].as<String>() == SENS::ENCODING_BINARY;
 
             it->second->setSensorCapabilities(&senCap);
         }
@@ -303,6 +401,7 @@ void DeviceManager::startRecord()
     {
         // here we set the startTime, isRecording to true and in the loop we constantly call hasStarted which checks if the delay has passed
         this->sampleCount = 0;
+        this->droppedSamples = 0;
         this->startTime = millis();
         this->isRecording = true;
 
@@ -331,10 +430,12 @@ void DeviceManager::stopRecord()
     }
     else
     {
-        // here we stop the record successfully and make a soft reset on the capabilities.
+        // here we stop the record successfully and make a soft reset on the capabilities. samples that are still waiting in the batch are sent before the response.
         this->isRecording = false;
+        this->relay->send(this->batch.flush());
         this->softResetRecordCapabilities();
 
+        doc["dropped_samples"] = this->droppedSamples;
         doc["success"] = true;
     }
 
@@ -346,6 +447,9 @@ void DeviceManager::resetCapabilities()
     this->capabilities.duration = DEVICE::DURATION;
     this->capabilities.maxSamples = DEVICE::MAX_SAMPLES;
     this->capabilities.delay = DEVICE::DELAY;
+    this->deviceCapabilities.batchMaxLatency = DEVICE::BATCH_MAX_LATENCY;
+    this->deviceCapabilities.batchMaxSamples = DEVICE::BATCH_MAX_SAMPLES;
+    this->deviceCapabilities.fecGroupSize = DEVICE::FEC_GROUP_SIZE;
 }
 
 void DeviceManager::softResetRecordCapabilities()
@@ -15,6 +15,7 @@
 #include "Identification.h"
 #include "PacketRelay.h"
 #include "ActuatorCommand.h"
+#include "SampleBatch.h"
 
 class DeviceManager: public IDeviceCapabilities, public IIdentification {
     public:
@@ -24,12 +25,14 @@ class DeviceManager: public IDeviceCapabilities, public IIdentification {
         void addSensor(SensorBase *sensor);
         void addActuator(ActuatorBase *actuator);
         ActuatorBase* getActuator(const String& id);
+        void setNetworkCapabilities(INetworkCapabilities *networkCapabilities);
         
         void updateSensors(); //update the board for sensors
         String getAllocatedHeap();
         bool isRecordInProgress();
         void isRecordComplete();
-        std::vector<std::shared_ptr<Packet>> readSensors();
+        std::vector<std::shared_ptr<Packet>> readSensors(size_t capacity);
+        unsigned long getTimeToNextSample();
         
         //command methods
         void restart();
@@ -46,12 +49,15 @@ class DeviceManager: public IDeviceCapabilities, public IIdentification {
         bool isRecording;
         unsigned long startTime;
         unsigned long sampleCount;
+        unsigned long droppedSamples;//samples that were skipped during the record because the network had no capacity
         std::map<String, SensorBase*> sensors;
         std::map<String, ActuatorBase*> actuators;
         Logger *logger;
         PacketRelay *relay;
         BoardBase *board;
         DeviceCapabilities deviceCapabilities;
+        SampleBatch batch;
+        INetworkCapabilities *networkCapabilities;
 
         void resetCapabilities() override;
         void identificationAction() override;
@@ -0,0 +1,126 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <memory>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "JsonArena.h"
+
+/**
+ * @class JsonArena
+ * @file JsonArena.cpp
+ * @brief Bump allocator for ArduinoJson, so that parsing a command does not allocate on the heap and the heap does not fragment from one short-lived document per command.
+ *
+ * Every block starts with a header that holds its size. Blocks are taken one after the other from the buffer; the newest block can grow, shrink and be freed in place, which covers how ArduinoJson builds strings and grows its pools. Older blocks are only freed with reset, which the owner of the document calls before the next document is parsed. A block that does not fit into the buffer is allocated on the heap and counted, so that the capacity can be tuned; such blocks are freed by ArduinoJson as usual.
+ */
+JsonArena::JsonArena(size_t capacity) : buffer(new uint8_t[capacity]), capacity(capacity), used(0), lastBlock(0), allocations(0), heapAllocations(0), highWater(0) {}
+
+void* JsonArena::allocate(size_t size)
+{
+    size_t header = JsonArena::align(sizeof(size_t));
+    size_t block = JsonArena::align(this->used);
+
+    if (block + header + size > this->capacity)
+    {
+        this->heapAllocations++;
+        return malloc(size);
+    }
+
+    void *pointer = this->buffer.get() + block + header;
+    this->getBlockSize(pointer) = size;
+
+    this->lastBlock = block;
+    this->used = block + header + size;
+    this->highWater = max(this->highWater, this->used);
+    this->allocations++;
+
+    return pointer;
+}
+
+void JsonArena::deallocate(void *pointer)
+{
+    if (!this->contains(pointer))
+    {
+        free(pointer);
+        return;
+    }
+
+    // only the newest block gives its memory back before reset
+    if ((uint8_t *)pointer - this->buffer.get() == this->lastBlock + JsonArena::align(sizeof(size_t)))
+        this->used = this->lastBlock;
+}
+
+void* JsonArena::reallocate(void *pointer, size_t size)
+{
+    if (pointer == nullptr)
+        return this->allocate(size);
+
+    if (!this->contains(pointer))
+        return realloc(pointer, size);
+
+    size_t &blockSize = this->getBlockSize(pointer);
+    size_t offset = (uint8_t *)pointer - this->buffer.get();
+    bool isLastBlock = offset == this->lastBlock + JsonArena::align(sizeof(size_t));
+
+    if (isLastBlock && offset + size <= this->capacity)
+    {
+        blockSize = size;
+        this->used = offset + size;
+        this->highWater = max(this->highWater, this->used);
+
+        return pointer;
+    }
+
+    if (size <= blockSize)
+        return pointer;
+
+    void *moved = this->allocate(size);
+    if (moved != nullptr)
+        memcpy(moved, pointer, blockSize);
+
+    return moved;
+}
+
+/**
+ * @brief releases all blocks of the buffer; the document that used them must be cleared before
+ */
+void JsonArena::reset()
+{
+    this->used = 0;
+    this->lastBlock = 0;
+}
+
+unsigned long JsonArena::getAllocations()
+{
+    return this->allocations;
+}
+
+unsigned long JsonArena::getHeapAllocations()
+{
+    return this->heapAllocations;
+}
+
+size_t JsonArena::getHighWater()
+{
+    return this->highWater;
+}
+
+bool JsonArena::contains(void *pointer)
+{
+    return pointer >= (void *)this->buffer.get() && pointer < (void *)(this->buffer.get() + this->capacity);
+}
+
+//the size is stored in the header in front of the block
+size_t& JsonArena::getBlockSize(void *pointer)
+{
+    return *(size_t *)((uint8_t *)pointer - JsonArena::align(sizeof(size_t)));
+}
+
+//blocks hold the pools of ArduinoJson, which store pointers and 64 bit values
+size_t JsonArena::align(size_t size)
+{
+    const size_t alignment = alignof(max_align_t);
+
+    return (size + alignment - 1) & ~(alignment - 1);
+}
@@ -0,0 +1,37 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <memory>
+
+//allocator for a JsonDocument that is parsed again and again, e.g. the received command; the memory of one document is taken from a fixed buffer and released at once with reset
+class JsonArena : public ArduinoJson::Allocator {
+    public:
+        JsonArena(size_t capacity);
+
+        void* allocate(size_t size) override;
+        void deallocate(void *pointer) override;
+        void* reallocate(void *pointer, size_t size) override;
+        void reset();
+
+        unsigned long getAllocations();
+        unsigned long getHeapAllocations();
+        size_t getHighWater();
+
+    private:
+        std::unique_ptr<uint8_t[]> buffer;
+        size_t capacity;
+        size_t used;//bytes from the start of the buffer that are taken
+        size_t lastBlock;//offset of the header of the newest block, which can grow, shrink and be freed in place
+
+        unsigned long allocations;//blocks taken from the buffer
+        unsigned long heapAllocations;//blocks that did not fit into the buffer
+        size_t highWater;
+
+        bool contains(void *pointer);
+        size_t& getBlockSize(void *pointer);
+        static size_t align(size_t size);
+};
+
+#endif
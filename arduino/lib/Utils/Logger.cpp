@@ -1,6 +1,5 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <queue>
 #include <vector>
 #include <memory>
 
@@ -20,7 +19,7 @@ Logger *Logger::getInstance() {
     return instance;
 }
 
-void Logger::setQueue(std::queue<std::shared_ptr<Packet>> *queue) {
+void Logger::setQueue(OutputQueue *queue) {
     /* we only want the queue from the networkmanager so that all logs are directed there; overriding the queue would lead to logs being lost. */
     if (this->logQueue == nullptr) {
         this->logQueue = queue;
@@ -37,7 +36,7 @@ void Logger::error(String &message) {
     char buffer[bufferSize];
     serializeJson(doc, buffer, bufferSize);
     
-    std::shared_ptr<Packet> packet = std::make_shared<Packet>();
+    std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
     packet->setMethod(NET::HEADER::METHOD_ERROR);
     packet->setPayload(buffer);
 
@@ -63,7 +62,7 @@ void Logger::debug(String &message) {
     char buffer[bufferSize];
     serializeJson(doc, buffer, bufferSize);
     
-    std::shared_ptr<Packet> packet = std::make_shared<Packet>();  
+    std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();  
     packet->setMethod(NET::HEADER::METHOD_DEBUG);
     packet->setPayload(buffer);
   
@@ -5,10 +5,10 @@
 #include <ArduinoJson.h>
 #include <map>
 #include <memory>
-#include <queue>
 #include <vector>
 
 #include "Packet.h"
+#include "OutputQueue.h"
 
 //prefixes a logger messages with file name and line number
 //code reference: https://gcc.gnu.org/onlinedocs/cpp/Standard-Predefined-Macros.html
@@ -19,7 +19,7 @@ class Logger {
         //https://refactoring.guru/design-patterns/singleton/cpp/example
         static Logger* getInstance();
 
-        void setQueue(std::queue<std::shared_ptr<Packet>> *queue);
+        void setQueue(OutputQueue *queue);
 
         void error(String &message);
         void ferror(String &message, std::vector<String> valuesToReplace);
@@ -37,7 +37,7 @@ class Logger {
         static Logger *instance; // Static instance pointer
         bool debugging;
         bool isEnabled;
-        std::queue<std::shared_ptr<Packet>> *logQueue;
+        OutputQueue *logQueue;
 };
 
 #endif
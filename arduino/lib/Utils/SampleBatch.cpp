@@ -0,0 +1,107 @@
+#include <Arduino.h>
+#include <vector>
+#include <memory>
+
+#include "SampleBatch.h"
+#include "Packet.h"
+#include "Config.h"
+
+/**
+ * @class SampleBatch
+ * @file SampleBatch.cpp
+ * @brief Aggregates samples into one packet so that the header, checksum and transport write are paid once per batch instead of once per sample.
+ *
+ * The payload of a batch packet is a sequence of samples, each prefixed with its length as uint16 in big endian (like the fields of the header):
+ * [length][sample][length][sample]...
+ * A sample is exactly the payload that would have been sent in a METHOD_DATA packet, so json and binary encoded samples can be mixed in one batch.
+ * The batch is flushed when the next sample does not fit into DEVICE::BATCH_MAX_PAYLOAD_SIZE, when it holds maxSamples samples or when the oldest sample is older than maxLatency milli seconds.
+ */
+SampleBatch::SampleBatch() : sampleCount(0), firstSampleTime(0), maxLatency(DEVICE::BATCH_MAX_LATENCY), maxSamples(DEVICE::BATCH_MAX_SAMPLES)
+{
+    this->payload.reserve(DEVICE::BATCH_MAX_PAYLOAD_SIZE);
+}
+
+void SampleBatch::configure(unsigned long maxLatency, unsigned long maxSamples)
+{
+    this->maxLatency = maxLatency;
+    this->maxSamples = maxSamples;
+}
+
+/**
+ * @brief batching is disabled if there is no latency budget or a batch may only hold a single sample
+ */
+bool SampleBatch::isEnabled()
+{
+    return this->maxLatency > 0 && this->maxSamples > 1;
+}
+
+bool SampleBatch::isEmpty()
+{
+    return this->sampleCount == 0;
+}
+
+bool SampleBatch::isFull()
+{
+    return this->sampleCount >= this->maxSamples;
+}
+
+/**
+ * @return true if the oldest sample in the batch has waited for maxLatency milli seconds
+ */
+bool SampleBatch::isDue(unsigned long now)
+{
+    return !this->isEmpty() && now - this->firstSampleTime >= this->maxLatency;
+}
+
+/**
+ * @return milli seconds until isDue returns true; UTIL::NO_DEADLINE if the batch is empty
+ */
+unsigned long SampleBatch::getTimeToDue(unsigned long now)
+{
+    if (this->isEmpty())
+        return UTIL::NO_DEADLINE;
+
+    unsigned long elapsed = now - this->firstSampleTime;
+
+    return elapsed >= this->maxLatency ? 0 : this->maxLatency - elapsed;
+}
+
+/**
+ * @return true if a sample with sampleSize bytes can be added to the current batch; samples that are larger than the whole batch never fit and must be sent on their own.
+ */
+bool SampleBatch::fits(size_t sampleSize)
+{
+    return this->payload.size() + sizeof(uint16_t) + sampleSize <= DEVICE::BATCH_MAX_PAYLOAD_SIZE;
+}
+
+void SampleBatch::add(const std::vector<uint8_t> &sample, unsigned long now)
+{
+    if (this->isEmpty())
+        this->firstSampleTime = now;
+
+    uint16_t length = sample.size();
+    this->payload.push_back(length >> 8);
+    this->payload.push_back(length >> 0);
+    this->payload.insert(this->payload.end(), sample.begin(), sample.end());
+
+    this->sampleCount++;
+}
+
+/**
+ * @brief creates the batch packet and starts a new batch
+ * @return the batch packet or nullptr if the batch is empty
+ */
+std::shared_ptr<Packet> SampleBatch::flush()
+{
+    if (this->isEmpty())
+        return nullptr;
+
+    std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+    packet->setMethod(NET::HEADER::METHOD_BATCH);
+    packet->setPayload(this->payload.data(), this->payload.size());
+
+    this->payload.clear();
+    this->sampleCount = 0;
+
+    return packet;
+}
@@ -0,0 +1,33 @@
+#ifndef SAMPLE_BATCH_H
+#define SAMPLE_BATCH_H
+
+#include <Arduino.h>
+#include <vector>
+#include <memory>
+
+#include "Packet.h"
+
+//collects sensor samples of one or more sensors into a single METHOD_BATCH packet
+class SampleBatch {
+    public:
+        SampleBatch();
+
+        void configure(unsigned long maxLatency, unsigned long maxSamples);
+        bool isEnabled();
+        bool isEmpty();
+        bool isFull();
+        bool isDue(unsigned long now);
+        unsigned long getTimeToDue(unsigned long now);
+        bool fits(size_t sampleSize);
+        void add(const std::vector<uint8_t> &sample, unsigned long now);
+        std::shared_ptr<Packet> flush();
+
+    private:
+        std::vector<uint8_t> payload;
+        unsigned long sampleCount;
+        unsigned long firstSampleTime;
+        unsigned long maxLatency;
+        unsigned long maxSamples;
+};
+
+#endif
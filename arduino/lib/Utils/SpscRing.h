@@ -0,0 +1,73 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <stddef.h>
+#include <utility>
+
+/**
+ * @class SpscRing
+ * @file SpscRing.h
+ * @brief Lock free ring buffer for exactly one producer task and one consumer task, e.g. the sampling task and the network task of the dual core build.
+ *
+ * head and tail only grow and are reduced to a slot with the mask, so a full and an empty ring can be told apart without a spare slot. The producer only writes tail and the consumer only writes head; the release store of one and the acquire load of the other make sure that an item is completely written before it can be read. Only std::atomic is used, so the ring works with FreeRTOS tasks and with std::thread alike.
+ * @tparam T type of the items; they are moved in and out
+ * @tparam Capacity number of items; must be a power of two
+ */
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "the capacity of a SpscRing must be a power of two");
+
+    public:
+        SpscRing() : head(0), tail(0) {}
+
+        /**
+         * @brief called by the producer only
+         * @return false if the ring is full; the item is not moved then
+         */
+        bool push(T &&item)
+        {
+            size_t currentTail = this->tail.load(std::memory_order_relaxed);
+            if (currentTail - this->head.load(std::memory_order_acquire) == Capacity)
+                return false;
+
+            this->slots[currentTail & (Capacity - 1)] = std::move(item);
+            this->tail.store(currentTail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        /**
+         * @brief called by the consumer only
+         * @return false if the ring is empty
+         */
+        bool pop(T &item)
+        {
+            size_t currentHead = this->head.load(std::memory_order_relaxed);
+            if (this->tail.load(std::memory_order_acquire) == currentHead)
+                return false;
+
+            item = std::move(this->slots[currentHead & (Capacity - 1)]);
+            this->head.store(currentHead + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        //the size may already be outdated when it is used: for the producer the ring can only have become emptier, for the consumer only fuller
+        size_t size()
+        {
+            return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+        }
+
+        size_t getRoom()
+        {
+            return Capacity - this->size();
+        }
+
+    private:
+        T slots[Capacity];
+        std::atomic<size_t> head;//next item to pop; written by the consumer
+        std::atomic<size_t> tail;//next slot to push; written by the producer
+};
+
+#endif
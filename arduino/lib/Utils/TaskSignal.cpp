@@ -0,0 +1,42 @@
+#include <Arduino.h>
+#include <atomic>
+
+#include "TaskSignal.h"
+
+/**
+ * @class TaskSignal
+ * @file TaskSignal.cpp
+ * @brief Lets a task sleep until its next deadline or until another task or a driver callback has work for it, instead of waking up every few milli seconds to poll.
+ *
+ * The signal uses the notification value of the FreeRTOS task, so it needs no queue or semaphore. Notifications that arrive while the task is busy are counted and make the next wait return at once, therefore no event is lost between the check for work and the wait.
+ */
+TaskSignal::TaskSignal() : task(nullptr) {}
+
+/**
+ * @brief makes the calling task the one that waits on this signal
+ */
+void TaskSignal::bind()
+{
+    this->task.store(xTaskGetCurrentTaskHandle());
+}
+
+/**
+ * @brief wakes the bound task. a task that notifies itself is awake anyway, so the notification is skipped; otherwise its next wait would return at once without any work.
+ * @note can be called from any task, e.g. the BLE or UART event task, but not from an interrupt
+ */
+void TaskSignal::notify()
+{
+    TaskHandle_t waitingTask = this->task.load();
+
+    if (waitingTask != nullptr && waitingTask != xTaskGetCurrentTaskHandle())
+        xTaskNotifyGive(waitingTask);
+}
+
+/**
+ * @brief blocks the calling task until it is notified or the timeout is over
+ * @param timeout milli seconds
+ */
+void TaskSignal::wait(unsigned long timeout)
+{
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout));
+}
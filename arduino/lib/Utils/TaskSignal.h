@@ -0,0 +1,20 @@
+#ifndef TASK_SIGNAL_H
+#define TASK_SIGNAL_H
+
+#include <Arduino.h>
+#include <atomic>
+
+//wakes a waiting task when there is work for it, e.g. received bytes or new sensor packets
+class TaskSignal {
+    public:
+        TaskSignal();
+
+        void bind();
+        void notify();
+        void wait(unsigned long timeout);
+
+    private:
+        std::atomic<TaskHandle_t> task;//task that waits on the signal; nullptr until bind is called
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include <ArduinoJson.h>
 #include <vector>
 #include <memory>
+#include <mutex>
 
 #include "PreferencesStorage.h"
 #include "AccelerometerSensor.h"
@@ -19,6 +20,9 @@
 #include "Logger.h"
 #include "Definitions.h"
 #include "Capabilities.h"
+#include "SpscRing.h"
+#include "PacketPool.h"
+#include "TaskSignal.h"
 
 #if WIRELESS_MODE == BLE
 #include "BluetoothProtocol.h"
@@ -35,12 +39,30 @@ DeviceManager *dm;
 CommandManager *cm;
 Logger *logger;
 
+#if DUAL_CORE
+//sensor packets that the sampling task has read and the network task has not yet put into the output queue
+SpscRing<std::shared_ptr<Packet>, MC::SAMPLE_RING_SIZE> sampleRing;
+//the devicemanager is used by the sampling task and by the commands that the network task executes
+std::mutex deviceLock;
+//wakes the network task on received data, new sensor packets and new packets in the output queue
+TaskSignal networkSignal;
+//wakes the sampling task after commands were executed, e.g. RECORD_START
+TaskSignal samplingSignal;
+
+void samplingTask(void *parameter);
+void networkTask(void *parameter);
+#else
+//wakes the loop on received data
+TaskSignal loopSignal;
+#endif
+
 void setup() {
 	//init networkmanager, commandmanager and devicemanager plus assisting classes
 	store = new PreferencesStorage(MC_NAME);
 	nm = new NetworkManager(store);
 	board = new BoardM5Stack();
 	dm = new DeviceManager(board);
+	dm->setNetworkCapabilities(nm);
 	cm = new CommandManager(*dm, *nm);
 	
 	//create logger for error and debug messages
@@ -68,26 +90,122 @@ void setup() {
 	//the command for the custom command must be unique in this project!
 	cm->addCommand(CUSTOM_CMD::SWITCH_ON, led);
 	cm->addCommand(CUSTOM_CMD::SWITCH_OFF, led);
+
+#if DUAL_CORE
+	nm->setSignal(&networkSignal);
+
+	//a slow BLE notify or UDP send on the network task no longer delays the next sensor read
+	xTaskCreatePinnedToCore(networkTask, "network", MC::NETWORK_TASK_STACK_SIZE, nullptr, MC::NETWORK_TASK_PRIORITY, nullptr, MC::NETWORK_TASK_CORE);
+	xTaskCreatePinnedToCore(samplingTask, "sampling", MC::SAMPLING_TASK_STACK_SIZE, nullptr, MC::SAMPLING_TASK_PRIORITY, nullptr, MC::SAMPLING_TASK_CORE);
+#else
+	//setup and loop run in the same task
+	loopSignal.bind();
+	nm->setSignal(&loopSignal);
+#endif
 	
 	logger->debug(prefix("setup finished"));
 }
 
+#if DUAL_CORE
+void loop() {
+	//the work is done by the tasks created in setup
+	vTaskDelete(nullptr);
+}
+
+void samplingTask(void *parameter) {
+	std::vector<std::shared_ptr<Packet>> sensorData;
+	unsigned long timeToNextSample;
+
+	samplingSignal.bind();
+
+	for (;;) {
+		{
+			std::lock_guard<std::mutex> guard(deviceLock);
+
+			if (dm->isRecordInProgress()) {
+				dm->updateSensors();
+
+				//the device manager only produces as many packets as the ring and the packet pool can take; the other samples are batched or skipped
+				sensorData = dm->readSensors(min(sampleRing.getRoom(), PacketPool::getInstance()->getRoom()));
+				dm->isRecordComplete();
+			}
+
+			timeToNextSample = dm->getTimeToNextSample();
+		}
+
+		for (std::shared_ptr<Packet> &packet : sensorData) {
+			sampleRing.push(std::move(packet));
+		}
+
+		if (!sensorData.empty()) {
+			networkSignal.notify();
+			sensorData.clear();
+		}
+
+		//sleeps until the next sensor is due instead of polling; a command wakes the task earlier
+		samplingSignal.wait(min(timeToNextSample, MC::MAX_IDLE_TIME));
+	}
+}
+
+void networkTask(void *parameter) {
+	std::vector<std::shared_ptr<Packet>> sensorData;
+
+	networkSignal.bind();
+
+	for (;;) {
+		nm->upgradeProtocol();
+
+		if (nm->isConnected()) {
+			nm->sendHeartbeatToClient();
+
+			std::vector<std::shared_ptr<Packet>> commands = nm->readIncomingData();
+
+			for (std::shared_ptr<Packet> &command : commands) {
+				std::lock_guard<std::mutex> guard(deviceLock);
+				cm->executeCommand(command);
+			}
+
+			//a command may have started a record or changed the sample rates
+			if (!commands.empty()) {
+				samplingSignal.notify();
+			}
+
+			//packets stay in the ring while the output queue has no room, so the sampling task sees the backpressure
+			std::shared_ptr<Packet> packet;
+			size_t capacity = nm->getSendCapacity();
+			while (sensorData.size() < capacity && sampleRing.pop(packet)) {
+				sensorData.push_back(std::move(packet));
+			}
+
+			nm->addSensorDataToOutput(sensorData);
+			sensorData.clear();
+
+			nm->writeOutgoingData();
+		}
+
+		//sleeps until the next deadline of the network (heartbeat, ACK, retransmission, protocol upgrade) or until data arrives; packets that are left in the ring are tried again after a milli second
+		unsigned long timeToNextEvent = sampleRing.size() > 0 ? 1 : nm->getTimeToNextEvent();
+		networkSignal.wait(min(timeToNextEvent, MC::MAX_IDLE_TIME));
+	}
+}
+#else
 void loop() {
 	nm->upgradeProtocol();
 
 	if (nm->isConnected()) {		
 		nm->sendHeartbeatToClient();
 		
-		std::vector<JsonDocument> commands = nm->readIncomingData();
+		std::vector<std::shared_ptr<Packet>> commands = nm->readIncomingData();
 
-		for (auto command : commands) {
-			cm->executeCommand(&command);			
+		for (std::shared_ptr<Packet> &command : commands) {
+			cm->executeCommand(command);
 		}
 
 		if (dm->isRecordInProgress()) {
 			dm->updateSensors();
 
-			std::vector<std::shared_ptr<Packet>> sensorData = dm->readSensors();
+			//the device manager only produces as many packets as the network and the packet pool can take; the other samples are batched or skipped
+			std::vector<std::shared_ptr<Packet>> sensorData = dm->readSensors(min(nm->getSendCapacity(), PacketPool::getInstance()->getRoom()));
 
 			//work with sensor data if needed			
 
@@ -95,6 +213,13 @@ void loop() {
 			dm->isRecordComplete();
 		}		
 		nm->writeOutgoingData();		
-	}	
-	delay(MC::LOOP_WAIT_TIME_DEFAULT);
-}
\ No newline at end of file
+	}
+
+	//sleeps until the next sensor or network deadline or until data arrives
+	unsigned long timeToNextEvent = nm->getTimeToNextEvent();
+	if (nm->isConnected()) {
+		timeToNextEvent = min(timeToNextEvent, dm->getTimeToNextSample());
+	}
+	loopSignal.wait(min(timeToNextEvent, MC::MAX_IDLE_TIME));
+}
+#endif
@@ -0,0 +1,31 @@
+#ifndef ADAFRUIT_NEOPIXEL_STUB_H
+#define ADAFRUIT_NEOPIXEL_STUB_H
+
+#include <Arduino.h>
+
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+//LED strip that keeps the colors without showing them
+class Adafruit_NeoPixel {
+    public:
+        Adafruit_NeoPixel() {}
+        Adafruit_NeoPixel(uint16_t numberOfPixels, int16_t pin, uint16_t type) : pixels(numberOfPixels, 0) {}
+
+        void begin() {}
+        void show() {}
+        void clear() { std::fill(this->pixels.begin(), this->pixels.end(), 0); }
+
+        void setPixelColor(uint16_t index, uint32_t color)
+        {
+            if (index < this->pixels.size())
+                this->pixels[index] = color;
+        }
+
+        static uint32_t Color(uint8_t red, uint8_t green, uint8_t blue) { return ((uint32_t)red << 16) | ((uint32_t)green << 8) | blue; }
+
+    private:
+        std::vector<uint32_t> pixels;
+};
+
+#endif
@@ -0,0 +1,283 @@
+#ifndef ARDUINO_STUB_H
+#define ARDUINO_STUB_H
+
+/**
+ * @file Arduino.h
+ * @brief thin stand-in for the Arduino core of the ESP32 so that the libraries in lib/ build for the native environment on a Linux host.
+ *
+ * Only what the firmware uses is provided: String, the clock, Serial as a port without data and the FreeRTOS task notifications. The clock runs with the steady clock of the host, or with a manual clock that a test or benchmark advances itself, so that timeouts and delays are reproducible. The task notifications are backed by a condition variable per thread, one thread being one task.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//String of the Arduino core on top of std::string; String + value returns a StringSumHelper like on the device, which binds to a String& parameter
+class StringSumHelper;
+
+class String {
+    public:
+        String() {}
+        String(const char *value) : value(value != nullptr ? value : "") {}
+        String(const std::string &value) : value(value) {}
+        String(char value) : value(1, value) {}
+        String(unsigned char value, unsigned char base = 10) : String((unsigned long)value, base) {}
+        String(int value, unsigned char base = 10) : String((long)value, base) {}
+        String(unsigned int value, unsigned char base = 10) : String((unsigned long)value, base) {}
+        String(long value, unsigned char base = 10) : value(value < 0 ? "-" + toBase((unsigned long)-value, base) : toBase(value, base)) {}
+        String(unsigned long value, unsigned char base = 10) : value(toBase(value, base)) {}
+        String(float value, unsigned int decimals = 2) : String((double)value, decimals) {}
+        String(double value, unsigned int decimals = 2)
+        {
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+            this->value = buffer;
+        }
+
+        //assigning nullptr empties the string like on the device
+        String &operator=(const char *value)
+        {
+            this->value = value != nullptr ? value : "";
+            return *this;
+        }
+
+        const char *c_str() const { return this->value.c_str(); }
+        unsigned int length() const { return this->value.length(); }
+        bool isEmpty() const { return this->value.empty(); }
+        bool reserve(unsigned int size) { this->value.reserve(size); return true; }
+        char charAt(unsigned int index) const { return index < this->value.size() ? this->value[index] : 0; }
+        char operator[](unsigned int index) const { return this->charAt(index); }
+        const char *begin() const { return this->c_str(); }
+        const char *end() const { return this->c_str() + this->length(); }
+
+        bool concat(const String &value) { this->value += value.value; return true; }
+        bool concat(const char *value) { this->value += value != nullptr ? value : ""; return true; }
+        bool concat(const char *value, unsigned int length) { this->value.append(value, length); return true; }
+        bool concat(char value) { this->value += value; return true; }
+        template <typename T>
+        String &operator+=(const T &value) { this->concat(String(value)); return *this; }
+
+        bool equals(const String &other) const { return this->value == other.value; }
+        bool operator==(const String &other) const { return this->value == other.value; }
+        bool operator==(const char *other) const { return this->value == (other != nullptr ? other : ""); }
+        bool operator!=(const String &other) const { return !(*this == other); }
+        bool operator!=(const char *other) const { return !(*this == other); }
+        bool operator<(const String &other) const { return this->value < other.value; }
+        bool startsWith(const String &prefix) const { return this->value.compare(0, prefix.value.size(), prefix.value) == 0; }
+        bool endsWith(const String &suffix) const { return this->value.size() >= suffix.value.size() && this->value.compare(this->value.size() - suffix.value.size(), suffix.value.size(), suffix.value) == 0; }
+
+        int indexOf(const String &value, unsigned int from = 0) const
+        {
+            size_t position = this->value.find(value.value, from);
+            return position == std::string::npos ? -1 : (int)position;
+        }
+
+        String substring(unsigned int from) const
+        {
+            return this->substring(from, this->length());
+        }
+
+        String substring(unsigned int from, unsigned int to) const
+        {
+            if (from > to)
+                std::swap(from, to);
+            if (from >= this->length())
+                return String();
+            return String(this->value.substr(from, to - from));
+        }
+
+        long toInt() const { return strtol(this->c_str(), nullptr, 10); }
+        float toFloat() const { return strtof(this->c_str(), nullptr); }
+
+    private:
+        std::string value;
+
+        static std::string toBase(unsigned long value, unsigned char base)
+        {
+            const char *digits = "0123456789abcdefghijklmnopqrstuvwxyz";
+            std::string result;
+            do
+            {
+                result.insert(result.begin(), digits[value % base]);
+                value /= base;
+            } while (value > 0);
+            return result;
+        }
+};
+
+class StringSumHelper : public String {
+    public:
+        StringSumHelper(const String &value) : String(value) {}
+        StringSumHelper(const char *value) : String(value) {}
+        StringSumHelper(char value) : String(value) {}
+        StringSumHelper(int value) : String(value) {}
+        StringSumHelper(unsigned int value) : String(value) {}
+        StringSumHelper(long value) : String(value) {}
+        StringSumHelper(unsigned long value) : String(value) {}
+        StringSumHelper(float value) : String(value) {}
+        StringSumHelper(double value) : String(value) {}
+};
+
+//the sum is appended to the temporary left operand, which lives until the end of the full expression
+template <typename T>
+inline StringSumHelper &operator+(const StringSumHelper &left, const T &right)
+{
+    StringSumHelper &sum = const_cast<StringSumHelper &>(left);
+    sum.concat(String(right));
+    return sum;
+}
+
+using std::max;
+using std::min;
+
+#define constrain(amount, low, high) ((amount) < (low) ? (low) : ((amount) > (high) ? (high) : (amount)))
+
+namespace ArduinoStub {
+    inline const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    inline bool manualClock = false;
+    inline unsigned long long manualMicros = 0;
+
+    //freezes millis() and micros(); they only move with advance()
+    inline void useManualClock(unsigned long startMillis = 0)
+    {
+        manualClock = true;
+        manualMicros = (unsigned long long)startMillis * 1000;
+    }
+
+    inline void useSteadyClock()
+    {
+        manualClock = false;
+    }
+
+    inline void advance(unsigned long milliSeconds)
+    {
+        manualMicros += (unsigned long long)milliSeconds * 1000;
+    }
+
+    inline unsigned long long elapsedMicros()
+    {
+        if (manualClock)
+            return manualMicros;
+
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+inline unsigned long millis() { return (unsigned long)(ArduinoStub::elapsedMicros() / 1000); }
+inline unsigned long micros() { return (unsigned long)ArduinoStub::elapsedMicros(); }
+
+inline void delay(unsigned long milliSeconds)
+{
+    if (ArduinoStub::manualClock)
+        ArduinoStub::advance(milliSeconds);
+    else
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliSeconds));
+}
+
+//a serial port that is never connected to a client: nothing is received and everything written is discarded
+class HardwareSerial {
+    public:
+        void begin(unsigned long baudrate) {}
+        void end() {}
+        int available() { return 0; }
+        int peek() { return -1; }
+        int read() { return -1; }
+        size_t readBytes(uint8_t *buffer, size_t length) { return 0; }
+        size_t readBytes(char *buffer, size_t length) { return 0; }
+        size_t write(uint8_t value) { return 1; }
+        size_t write(const uint8_t *buffer, size_t length) { return length; }
+        void onReceive(std::function<void(void)> callback, bool onlyOnTimeout = false) {}
+        operator bool() { return true; }
+};
+
+inline HardwareSerial Serial;
+
+// FreeRTOS
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define portMAX_DELAY 0xffffffffUL
+#define pdMS_TO_TICKS(milliSeconds) ((TickType_t)(milliSeconds))
+
+namespace ArduinoStub {
+    struct Task {
+        std::mutex lock;
+        std::condition_variable notified;
+        uint32_t notifications = 0;
+    };
+
+    inline Task &currentTask()
+    {
+        thread_local Task task;
+        return task;
+    }
+}
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    return &ArduinoStub::currentTask();
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t handle)
+{
+    ArduinoStub::Task *task = (ArduinoStub::Task *)handle;
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notifications++;
+    }
+    task->notified.notify_one();
+
+    return pdPASS;
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks)
+{
+    ArduinoStub::Task &task = ArduinoStub::currentTask();
+    std::unique_lock<std::mutex> guard(task.lock);
+
+    if (ticks == portMAX_DELAY)
+        task.notified.wait(guard, [&task] { return task.notifications > 0; });
+    else
+        task.notified.wait_for(guard, std::chrono::milliseconds(ticks), [&task] { return task.notifications > 0; });
+
+    uint32_t value = task.notifications;
+    if (value > 0)
+        task.notifications = clearOnExit ? 0 : value - 1;
+
+    return value;
+}
+
+//every task is a detached thread; the core and the priority have no meaning on the host
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stackSize, void *parameter, unsigned int priority, TaskHandle_t *handle, int core)
+{
+    std::thread(function, parameter).detach();
+
+    return pdPASS;
+}
+
+inline void vTaskDelay(TickType_t ticks)
+{
+    delay(ticks);
+}
+
+//only the calling task can be deleted on the host; its thread ends when the task function returns
+inline void vTaskDelete(TaskHandle_t handle) {}
+
+#endif
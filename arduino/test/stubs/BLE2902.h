@@ -0,0 +1,9 @@
+#ifndef BLE2902_STUB_H
+#define BLE2902_STUB_H
+
+#include <BLEDevice.h>
+
+//client characteristic configuration descriptor that lets a client enable the notifications
+class BLE2902 : public BLEDescriptor {};
+
+#endif
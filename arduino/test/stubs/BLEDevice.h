@@ -0,0 +1,107 @@
+#ifndef BLE_DEVICE_STUB_H
+#define BLE_DEVICE_STUB_H
+
+#include <Arduino.h>
+
+//BLE stack of the ESP32 without a radio: the server advertises to nobody and notifications are discarded
+
+class BLECharacteristic;
+class BLEServer;
+
+class BLEDescriptor {
+    public:
+        virtual ~BLEDescriptor() {}
+};
+
+class BLECharacteristicCallbacks {
+    public:
+        virtual ~BLECharacteristicCallbacks() {}
+        virtual void onWrite(BLECharacteristic *characteristic) {}
+};
+
+class BLEServerCallbacks {
+    public:
+        virtual ~BLEServerCallbacks() {}
+        virtual void onConnect(BLEServer *server) {}
+        virtual void onDisconnect(BLEServer *server) {}
+};
+
+class BLECharacteristic {
+    public:
+        static const uint32_t PROPERTY_READ = 1 << 0;
+        static const uint32_t PROPERTY_WRITE = 1 << 1;
+        static const uint32_t PROPERTY_NOTIFY = 1 << 2;
+
+        void setCallbacks(BLECharacteristicCallbacks *callbacks) { this->callbacks = callbacks; }
+        void addDescriptor(BLEDescriptor *descriptor) { this->descriptors.emplace_back(descriptor); }
+        void setValue(uint8_t *data, size_t length) { this->value.assign((const char *)data, length); }
+        void notify() {}
+        uint8_t *getData() { return (uint8_t *)this->value.data(); }
+        std::string getValue() { return this->value; }
+
+    private:
+        BLECharacteristicCallbacks *callbacks = nullptr;
+        std::vector<std::unique_ptr<BLEDescriptor>> descriptors;
+        std::string value;
+};
+
+class BLEAdvertising {
+    public:
+        void addServiceUUID(const char *uuid) {}
+        void start() {}
+        void stop() {}
+};
+
+class BLEService {
+    public:
+        BLECharacteristic *createCharacteristic(const char *uuid, uint32_t properties)
+        {
+            this->characteristics.emplace_back(new BLECharacteristic());
+            return this->characteristics.back().get();
+        }
+        void start() {}
+
+    private:
+        std::vector<std::unique_ptr<BLECharacteristic>> characteristics;
+};
+
+class BLEServer {
+    public:
+        void setCallbacks(BLEServerCallbacks *callbacks) { this->callbacks = callbacks; }
+        BLEService *createService(const char *uuid)
+        {
+            this->services.emplace_back(new BLEService());
+            return this->services.back().get();
+        }
+        BLEAdvertising *getAdvertising() { return &this->advertising; }
+        void disconnect(uint16_t connectionId) {}
+        void updatePeerMTU(uint16_t connectionId, uint16_t mtu) { this->mtu = mtu; }
+        uint16_t getPeerMTU(uint16_t connectionId) { return this->mtu; }
+        uint16_t getConnId() { return 0; }
+
+    private:
+        BLEServerCallbacks *callbacks = nullptr;
+        std::vector<std::unique_ptr<BLEService>> services;
+        BLEAdvertising advertising;
+        uint16_t mtu = 23;
+};
+
+class BLEDevice {
+    public:
+        static void init(const char *name) {}
+        static BLEServer *createServer()
+        {
+            server().reset(new BLEServer());
+            return server().get();
+        }
+        static void deinit(bool releaseMemory) { server().reset(); }
+
+    private:
+        static std::unique_ptr<BLEServer> &server()
+        {
+            static std::unique_ptr<BLEServer> instance;
+            return instance;
+        }
+};
+
+#endif
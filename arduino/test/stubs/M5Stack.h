@@ -0,0 +1,67 @@
+#ifndef M5STACK_STUB_H
+#define M5STACK_STUB_H
+
+#include <Arduino.h>
+
+//M5Stack Fire at rest: the buttons are released, the IMU reads zero, the battery is full and the display and speaker show and play nothing
+
+#define TFT_BLACK 0x0000
+#define TFT_BLUE 0x001F
+#define TFT_RED 0xF800
+#define TFT_GREEN 0x07E0
+#define TFT_WHITE 0xFFFF
+
+class Button {
+    public:
+        uint8_t isPressed() { return 0; }
+        uint8_t wasPressed() { return 0; }
+};
+
+class MPU6886 {
+    public:
+        int Init() { return 0; }
+        void getAccelData(float *x, float *y, float *z) { *x = 0; *y = 0; *z = 0; }
+        void getGyroData(float *x, float *y, float *z) { *x = 0; *y = 0; *z = 0; }
+        void getAhrsData(float *pitch, float *roll, float *yaw) { *pitch = 0; *roll = 0; *yaw = 0; }
+        void getTempData(float *temperature) { *temperature = 0; }
+};
+
+class POWER {
+    public:
+        bool begin() { return true; }
+        int8_t getBatteryLevel() { return 100; }
+        bool isCharging() { return false; }
+        void reset() {}
+};
+
+class M5Display {
+    public:
+        void setBrightness(uint8_t brightness) {}
+        void fillScreen(uint32_t color) {}
+};
+
+class SPEAKER {
+    public:
+        void end() {}
+        void mute() {}
+        void beep() {}
+};
+
+class M5Stack {
+    public:
+        void begin() {}
+        void update() {}
+
+        Button BtnA;
+        Button BtnB;
+        Button BtnC;
+        MPU6886 Imu;
+        MPU6886 &IMU = Imu;
+        POWER Power;
+        M5Display Lcd;
+        SPEAKER Speaker;
+};
+
+inline M5Stack M5;
+
+#endif
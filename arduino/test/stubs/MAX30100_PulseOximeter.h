@@ -0,0 +1,15 @@
+#ifndef MAX30100_PULSE_OXIMETER_STUB_H
+#define MAX30100_PULSE_OXIMETER_STUB_H
+
+#include <Arduino.h>
+
+//pulse oximeter without a finger on it
+class PulseOximeter {
+    public:
+        bool begin() { return true; }
+        void update() {}
+        float getHeartRate() { return 0; }
+        uint8_t getSpO2() { return 0; }
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef PREFERENCES_STUB_H
+#define PREFERENCES_STUB_H
+
+#include <Arduino.h>
+#include <map>
+
+//non-volatile storage of the ESP32 kept in memory; the values of all namespaces live as long as the process
+class Preferences {
+    public:
+        bool begin(const char *name, bool readOnly = false)
+        {
+            this->name = name;
+            return true;
+        }
+
+        void end() {}
+
+        bool isKey(const char *key) { return values().count(this->name + "/" + key) > 0; }
+
+        String getString(const char *key, const String defaultValue = String())
+        {
+            auto entry = values().find(this->name + "/" + key);
+            return entry != values().end() ? entry->second : defaultValue;
+        }
+
+        size_t putString(const char *key, const String value)
+        {
+            values()[this->name + "/" + key] = value;
+            return value.length();
+        }
+
+        bool remove(const char *key) { return values().erase(this->name + "/" + key) > 0; }
+
+    private:
+        String name;
+
+        static std::map<String, String> &values()
+        {
+            static std::map<String, String> storage;
+            return storage;
+        }
+};
+
+#endif
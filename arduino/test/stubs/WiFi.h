@@ -0,0 +1,40 @@
+#ifndef WIFI_STUB_H
+#define WIFI_STUB_H
+
+#include <Arduino.h>
+
+//WiFi station that never connects to an access point
+
+enum WiFiEvent_t {
+    ARDUINO_EVENT_WIFI_STA_CONNECTED,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP
+};
+
+struct WiFiEventInfo_t {};
+
+enum wifi_mode_t {
+    WIFI_OFF,
+    WIFI_STA,
+    WIFI_AP,
+    WIFI_AP_STA
+};
+
+enum wl_status_t {
+    WL_IDLE_STATUS,
+    WL_CONNECTED,
+    WL_DISCONNECTED
+};
+
+class WiFiClass {
+    public:
+        bool mode(wifi_mode_t mode) { return true; }
+        wl_status_t begin(const String &ssid, const String &password) { return WL_DISCONNECTED; }
+        int onEvent(std::function<void(WiFiEvent_t, WiFiEventInfo_t)> callback, WiFiEvent_t event) { return 0; }
+        bool disconnect(bool wifiOff = false) { return true; }
+        wl_status_t status() { return WL_DISCONNECTED; }
+};
+
+inline WiFiClass WiFi;
+
+#endif
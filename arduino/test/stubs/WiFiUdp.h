@@ -0,0 +1,25 @@
+#ifndef WIFI_UDP_STUB_H
+#define WIFI_UDP_STUB_H
+
+#include <Arduino.h>
+
+//UDP socket without a network: datagrams are discarded and none arrive
+class WiFiUDP {
+    public:
+        uint8_t begin(uint16_t port) { return 1; }
+        void stop() {}
+        int beginPacket(const char *host, uint16_t port) { return 1; }
+        size_t write(uint8_t value) { return 1; }
+        size_t write(const uint8_t *buffer, size_t length) { return length; }
+        int endPacket() { return 1; }
+        int parsePacket() { return 0; }
+        int available() { return 0; }
+        int peek() { return -1; }
+        int read() { return -1; }
+        int read(uint8_t *buffer, size_t length) { return 0; }
+        int read(char *buffer, size_t length) { return 0; }
+        size_t readBytes(uint8_t *buffer, size_t length) { return 0; }
+        size_t readBytes(char *buffer, size_t length) { return 0; }
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef ESP_HEAP_CAPS_STUB_H
+#define ESP_HEAP_CAPS_STUB_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+
+//heap of the ESP32 without PSRAM that is always empty; the host process has no comparable figure
+inline size_t heap_caps_get_total_size(uint32_t caps) { return 320 * 1024; }
+inline size_t heap_caps_get_free_size(uint32_t caps) { return 320 * 1024; }
+
+#endif
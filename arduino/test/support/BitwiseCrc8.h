@@ -0,0 +1,45 @@
+#ifndef BITWISE_CRC8_H
+#define BITWISE_CRC8_H
+
+#include <Arduino.h>
+
+/**
+ * @file BitwiseCrc8.h
+ * @brief calcCRC8 of RobTillaart/CRC, which computed the packet checksum before the lookup table in Checksum.cpp: every input byte is reflected and shifted through the register bit by bit. kept for the host tests and benchmarks as the reference that Checksum::crc8 must match.
+ * @cite https://github.com/RobTillaart/CRC
+ */
+inline uint8_t reverse8(uint8_t value)
+{
+    value = (value & 0xF0) >> 4 | (value & 0x0F) << 4;
+    value = (value & 0xCC) >> 2 | (value & 0x33) << 2;
+    value = (value & 0xAA) >> 1 | (value & 0x55) << 1;
+
+    return value;
+}
+
+inline uint8_t calcCRC8(const uint8_t *array, uint16_t length, uint8_t polynome = 0xD5, uint8_t startmask = 0x00, uint8_t endmask = 0x00, bool reverseIn = false, bool reverseOut = false)
+{
+    uint8_t crc = startmask;
+
+    while (length--)
+    {
+        uint8_t data = *array++;
+        if (reverseIn)
+            data = reverse8(data);
+        crc ^= data;
+        for (uint8_t i = 8; i; i--)
+        {
+            if (crc & 0x80)
+                crc = (crc << 1) ^ polynome;
+            else
+                crc <<= 1;
+        }
+    }
+    crc ^= endmask;
+    if (reverseOut)
+        crc = reverse8(crc);
+
+    return crc;
+}
+
+#endif
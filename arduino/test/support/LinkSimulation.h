@@ -0,0 +1,222 @@
+#ifndef LINK_SIMULATION_H
+#define LINK_SIMULATION_H
+
+#include <Arduino.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "IntegrityMiddleware.h"
+#include "LoopbackProtocol.h"
+#include "LossyLink.h"
+#include "OutputQueue.h"
+#include "Packet.h"
+#include "PacketPool.h"
+#include "RelayQueue.h"
+#include "Config.h"
+
+struct LinkSimulationResult {
+    size_t sentPackets; //RELIABLE packets that the sender wrote for the first time
+    size_t retransmittedPackets;
+    size_t deliveredPackets; //packets that the receiver released in order
+    size_t missingPackets; //packets that the sender wrote but the receiver never released
+    size_t deliveredBytes; //payload bytes of the delivered packets
+    bool inOrder; //every delivered packet was the one after the previously delivered packet or a later one
+    size_t duplicatePackets; //delivered packets that were already delivered before
+    unsigned long duration; //simulated milli seconds until nothing was pending anymore or the time limit was reached
+    size_t reorderBufferHighWater; //most packets that waited in the reorder buffer of the receiver at the same time
+    size_t packetsHighWater; //most packet slots in use at the same time, over both ends
+    size_t payloadsHighWater; //most payload slots in use at the same time, over both ends
+    unsigned long heapPackets; //packets and payloads that came from the heap because the pool was exhausted
+    LossyLinkStatistics link;
+
+    double getGoodput() //payload bytes per simulated second
+    {
+        return this->duration > 0 ? this->deliveredBytes * 1000.0 / this->duration : 0;
+    }
+
+    double getRetransmitRatio() //retransmissions per packet that was sent
+    {
+        return this->sentPackets > 0 ? (double)this->retransmittedPackets / this->sentPackets : 0;
+    }
+};
+
+/**
+ * @brief two IntegrityMiddleware instances back to back on the host: the sender writes numbered RELIABLE packets through a LossyLink and a LoopbackProtocol to the receiver, which answers with ACKs the same way back. The clock is the manual clock of the Arduino stub and advances by one milli second per step, and all impairments come from the seeded LossyLink, therefore a run with the same seed, impairments and packets always gives the same result.
+ *
+ * Both ends are driven like the NetworkManager drives one end: read and process the received packets, flush a due ACK, write the retransmissions and then the new packets. The ACK packets of a middleware go through the PacketRelay into the relay queue, which is written out by the end whose turn it is, so each end sends its own ACKs.
+ */
+class LinkSimulation {
+    public:
+        LinkSimulation(uint32_t seed, LossyLinkImpairments impairments) : link(seed, impairments)
+        {
+            this->senderWire.connect(&this->receiverWire);
+            this->link.setProtocol(&this->senderWire);
+            this->sender.enableAckPackets();
+            this->receiver.enableAckPackets();
+            getRelayQueue()->clear();
+        }
+
+        /**
+         * @param packetCount packets that the sender writes as fast as its send window allows
+         * @param payloadLength bytes per payload, at least 8 for the number of the packet
+         * @param timeLimit simulated milli seconds after which the run stops even if packets are still pending
+         */
+        LinkSimulationResult run(size_t packetCount, size_t payloadLength, unsigned long timeLimit)
+        {
+            LinkSimulationResult result = {};
+            result.inOrder = true;
+            this->nextNumber = 0;
+            this->lastDelivered = -1;
+            std::vector<bool> delivered(packetCount, false);
+            PacketPoolStatistics start = PacketPool::getInstance()->getStatistics();
+
+            ArduinoStub::useManualClock(0);
+
+            unsigned long now = 0;
+            for (; now < timeLimit; now++, ArduinoStub::advance(1))
+            {
+                this->senderTurn(packetCount, payloadLength, result);
+                this->receiverTurn(delivered, result);
+
+                PacketPoolStatistics pool = PacketPool::getInstance()->getStatistics();
+                result.packetsHighWater = max(result.packetsHighWater, pool.packetsInUse);
+                result.payloadsHighWater = max(result.payloadsHighWater, pool.payloadsInUse);
+                result.reorderBufferHighWater = max(result.reorderBufferHighWater, this->receiver.getReorderBufferSize());
+
+                if (this->nextNumber == packetCount && this->isIdle())
+                    break;
+            }
+
+            PacketPoolStatistics end = PacketPool::getInstance()->getStatistics();
+            result.missingPackets = std::count(delivered.begin(), delivered.begin() + this->nextNumber, false);
+            result.heapPackets = end.packetsExhausted - start.packetsExhausted + end.payloadsExhausted - start.payloadsExhausted;
+            result.duration = now;
+            result.link = this->link.getStatistics();
+
+            ArduinoStub::useSteadyClock();
+
+            return result;
+        }
+
+    private:
+        LoopbackProtocol senderWire;
+        LoopbackProtocol receiverWire;
+        LossyLink link; //impairs both directions at the sender like in a LOSSY_LINK=1 build
+        IntegrityMiddleware sender;
+        IntegrityMiddleware receiver;
+        std::vector<std::shared_ptr<Packet>> batch;
+        std::shared_ptr<Packet> nextPacket; //waits for a free slot in the send window
+        size_t nextNumber;
+        long lastDelivered;
+
+        std::shared_ptr<Packet> makePacket(size_t number, size_t payloadLength)
+        {
+            char number8[9];
+            snprintf(number8, sizeof(number8), "%08u", (unsigned int)number);
+            std::string payload(number8);
+            payload.resize(max(payloadLength, payload.size()), 'x');
+
+            std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+            packet->setMethod(NET::HEADER::METHOD_INFO);
+            packet->setPayload(payload.c_str());
+
+            return packet;
+        }
+
+        //moves the ACK and parity packets that the middleware queued during this turn into the batch
+        void takeRelayedPackets(IntegrityMiddleware &middleware)
+        {
+            OutputQueue *queue = getRelayQueue();
+
+            for (uint8_t i = 0; i < OutputQueue::CLASS_COUNT; i++)
+            {
+                OutputQueue::Class outputClass = (OutputQueue::Class)i;
+                std::shared_ptr<Packet> packet;
+                while ((packet = queue->front(outputClass)) != nullptr)
+                {
+                    queue->pop(outputClass, packet);
+                    this->batch.push_back(middleware.processOutgoingData(std::move(packet)));
+                }
+            }
+        }
+
+        void senderTurn(size_t packetCount, size_t payloadLength, LinkSimulationResult &result)
+        {
+            std::shared_ptr<Packet> packet;
+            while ((packet = this->link.readPacket()) != nullptr)
+            {
+                this->sender.processIncomingData(std::move(packet));
+            }
+
+            this->batch.clear();
+            this->sender.flushAcknowledgement();
+            this->sender.collectRetransmissions(this->batch);
+            result.retransmittedPackets += this->batch.size();
+            this->takeRelayedPackets(this->sender);
+
+            while (this->nextNumber < packetCount)
+            {
+                if (this->nextPacket == nullptr)
+                    this->nextPacket = this->makePacket(this->nextNumber, payloadLength);
+                if (!this->sender.canSend(this->nextPacket))
+                    break;
+
+                this->batch.push_back(this->sender.processOutgoingData(std::move(this->nextPacket)));
+                this->nextPacket = nullptr;
+                this->nextNumber++;
+                result.sentPackets++;
+            }
+            this->takeRelayedPackets(this->sender);
+
+            if (!this->batch.empty())
+                this->link.writePackets(this->batch);
+        }
+
+        void receiverTurn(std::vector<bool> &delivered, LinkSimulationResult &result)
+        {
+            std::shared_ptr<Packet> packet;
+            while ((packet = this->receiverWire.readPacket()) != nullptr)
+            {
+                for (std::shared_ptr<Packet> &data : this->receiver.processIncomingData(std::move(packet)))
+                {
+                    if (data->getMethod() != NET::HEADER::METHOD_INFO)
+                        continue;
+
+                    long number = strtol(data->getPayloadView(), nullptr, 10);
+                    if (number <= this->lastDelivered)
+                        result.inOrder = false;
+                    this->lastDelivered = number;
+
+                    if (number < 0 || (size_t)number >= delivered.size())
+                        continue;
+
+                    if (delivered[number])
+                    {
+                        result.duplicatePackets++;
+                        continue;
+                    }
+
+                    delivered[number] = true;
+                    result.deliveredPackets++;
+                    result.deliveredBytes += data->getPayloadLength();
+                }
+            }
+
+            this->batch.clear();
+            this->receiver.flushAcknowledgement();
+            this->takeRelayedPackets(this->receiver);
+
+            if (!this->batch.empty())
+                this->receiverWire.writePackets(this->batch);
+        }
+
+        //every packet of the sender was acknowledged or given up and nothing waits in the link
+        bool isIdle()
+        {
+            return this->sender.getInFlight() == 0 && this->link.getStatistics().queuedPackets == 0;
+        }
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef LOOPBACK_PROTOCOL_H
+#define LOOPBACK_PROTOCOL_H
+
+#include <Arduino.h>
+#include <memory>
+
+#include "ProtocolBase.h"
+#include "Packet.h"
+#include "Config.h"
+
+//one end of an in-memory wire: the bytes of a written packet are fed to the parser of the other end, like a serial cable without loss
+class LoopbackProtocol : public ProtocolBase {
+    public:
+        LoopbackProtocol() : ProtocolBase("LOOPBACK", NET::MAX_BUFFER_SIZE), peer(nullptr) {}
+
+        void connect(LoopbackProtocol *peer)
+        {
+            this->peer = peer;
+            peer->peer = this;
+        }
+
+        void init() override {}
+        void destroy() override {}
+
+        void writePacket(std::shared_ptr<Packet> packet) override
+        {
+            if (this->peer == nullptr)
+                return;
+
+            size_t size = this->serializeToTxBuffer(packet);
+            this->peer->parser.feed(this->getTxBuffer(), size);
+        }
+
+        std::shared_ptr<Packet> readPacket() override
+        {
+            return this->parser.next();
+        }
+
+        bool checkConnection() override
+        {
+            return this->peer != nullptr;
+        }
+
+    private:
+        LoopbackProtocol *peer;
+};
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef RELAY_QUEUE_H
+#define RELAY_QUEUE_H
+
+#include "OutputQueue.h"
+#include "PacketRelay.h"
+
+//the queue that the PacketRelay pushes ACK and parity packets to on the host. the relay keeps the first queue it gets for the whole process, so every test and benchmark in one program must use this one.
+inline OutputQueue *getRelayQueue()
+{
+    static OutputQueue queue;
+    PacketRelay::getInstance()->setQueue(&queue);
+
+    return &queue;
+}
+
+#endif
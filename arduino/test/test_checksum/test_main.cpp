@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "BitwiseCrc8.h"
+#include "Checksum.h"
+#include "Packet.h"
+#include "PacketPool.h"
+#include "Config.h"
+
+//the call that Packet::calculateChecksum made before the lookup table
+static uint8_t previousChecksum(const uint8_t *data, size_t length)
+{
+    return calcCRC8(data, length, 0xa7, 0x00, 0x00, true, true);
+}
+
+TEST(Checksum, MatchesTheCheckValueOfCrc8Bluetooth)
+{
+    const char *check = "123456789";
+
+    EXPECT_EQ(0x26, Checksum::crc8((const uint8_t *)check, strlen(check)));
+    EXPECT_EQ(0x26, previousChecksum((const uint8_t *)check, strlen(check)));
+}
+
+TEST(Checksum, IsZeroForAnEmptyBuffer)
+{
+    EXPECT_EQ(0x00, Checksum::crc8(nullptr, 0));
+}
+
+TEST(Checksum, MatchesBitwiseCrcForEverySingleByte)
+{
+    for (int value = 0; value < 256; value++)
+    {
+        uint8_t data = value;
+        EXPECT_EQ(previousChecksum(&data, 1), Checksum::crc8(&data, 1)) << "byte " << value;
+    }
+}
+
+TEST(Checksum, MatchesBitwiseCrcForRandomBuffers)
+{
+    std::mt19937 random(4);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<size_t> length(1, NET::MAX_BUFFER_SIZE);
+
+    for (int i = 0; i < 10000; i++)
+    {
+        std::vector<uint8_t> data(length(random));
+        for (uint8_t &value : data)
+        {
+            value = byte(random);
+        }
+
+        ASSERT_EQ(previousChecksum(data.data(), data.size()), Checksum::crc8(data.data(), data.size())) << "buffer " << i << " with " << data.size() << " bytes";
+    }
+}
+
+TEST(Checksum, PacketChecksumCoversThePayloadWithoutTerminator)
+{
+    const char *payload = "{\"cmd_name\":\"BATTERY_READ\"}";
+    std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+    packet->setMethod(NET::HEADER::METHOD_COMMAND);
+    packet->setPayload(payload);
+
+    EXPECT_EQ(previousChecksum((const uint8_t *)payload, strlen(payload)), packet->getChecksum());
+    EXPECT_TRUE(packet->verifyGoodPacket());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
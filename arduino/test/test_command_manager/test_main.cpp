@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <memory>
+
+#include "CommandManager.h"
+#include "CommandBase.h"
+#include "DeviceManager.h"
+#include "NetworkManager.h"
+#include "PreferencesStorage.h"
+#include "BoardM5Stack.h"
+#include "PacketPool.h"
+#include "Packet.h"
+#include "Config.h"
+
+//command that only counts how often it ran and sums its parameter
+class CountCommand : public CommandBase {
+    public:
+        void execute(JsonDocument *json) override
+        {
+            this->executions++;
+            this->sum += (*json)["value"].as<long>();
+        }
+
+        unsigned long executions = 0;
+        long sum = 0;
+};
+
+//one set of managers like in main.cpp; the Logger and the PacketRelay keep the queue of the first NetworkManager
+class CommandManagerTest : public ::testing::Test {
+    protected:
+        static void SetUpTestSuite()
+        {
+            storage = new PreferencesStorage(MC_NAME);
+            networkManager = new NetworkManager(storage);
+            deviceManager = new DeviceManager(new BoardM5Stack());
+        }
+
+        static std::shared_ptr<Packet> createCommand(const String &payload)
+        {
+            std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+            packet->setMethod(NET::HEADER::METHOD_COMMAND);
+            packet->setPayload(payload.c_str());
+
+            return packet;
+        }
+
+        static Storage *storage;
+        static NetworkManager *networkManager;
+        static DeviceManager *deviceManager;
+};
+
+Storage *CommandManagerTest::storage = nullptr;
+NetworkManager *CommandManagerTest::networkManager = nullptr;
+DeviceManager *CommandManagerTest::deviceManager = nullptr;
+
+TEST_F(CommandManagerTest, ParsesCommandsWithoutHeapAllocations)
+{
+    CommandManager commandManager(*deviceManager, *networkManager);
+    CountCommand count;
+    commandManager.addCommand("count", &count);
+
+    const long commands = 10000;
+    for (long i = 0; i < commands; i++)
+    {
+        std::shared_ptr<Packet> packet = createCommand(String("{\"cmd_name\":\"count\",\"value\":") + i + "}");
+        commandManager.executeCommand(packet);
+    }
+
+    EXPECT_EQ((unsigned long)commands, count.executions);
+    EXPECT_EQ(commands * (commands - 1) / 2, count.sum);
+    EXPECT_EQ(0u, commandManager.getHeapAllocations());
+}
+
+TEST_F(CommandManagerTest, ParsesACommandLargerThanTheArenaFromTheHeap)
+{
+    CommandManager commandManager(*deviceManager, *networkManager);
+    CountCommand count;
+    commandManager.addCommand("count", &count);
+
+    // one string longer than the whole arena, still within the payload the parser accepts
+    String padding;
+    while (padding.length() < MC::COMMAND_ARENA_SIZE + 64)
+        padding += "0123456789abcdef";
+    ASSERT_LT(padding.length() + 64, NET::PARSER_MAX_PAYLOAD_SIZE);
+
+    std::shared_ptr<Packet> large = createCommand(String("{\"cmd_name\":\"count\",\"value\":1,\"padding\":\"") + padding + "\"}");
+    commandManager.executeCommand(large);
+    unsigned long heapAllocations = commandManager.getHeapAllocations();
+
+    // the arena is reset for the next command, which fits again
+    std::shared_ptr<Packet> small = createCommand("{\"cmd_name\":\"count\",\"value\":2}");
+    commandManager.executeCommand(small);
+
+    EXPECT_EQ(2u, count.executions);
+    EXPECT_EQ(3, count.sum);
+    EXPECT_GT(heapAllocations, 0u);
+    EXPECT_EQ(heapAllocations, commandManager.getHeapAllocations());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
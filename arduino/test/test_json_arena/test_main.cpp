@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "JsonArena.h"
+
+static bool isAligned(void *pointer)
+{
+    return (uintptr_t)pointer % alignof(max_align_t) == 0;
+}
+
+TEST(JsonArena, TakesBlocksFromTheBuffer)
+{
+    JsonArena arena(1024);
+
+    void *first = arena.allocate(100);
+    void *second = arena.allocate(100);
+
+    ASSERT_NE(nullptr, first);
+    EXPECT_TRUE(isAligned(first));
+    EXPECT_TRUE(isAligned(second));
+    EXPECT_GE((uint8_t *)second, (uint8_t *)first + 100);
+    EXPECT_EQ(2u, arena.getAllocations());
+    EXPECT_EQ(0u, arena.getHeapAllocations());
+    EXPECT_GE(arena.getHighWater(), 200u);
+}
+
+TEST(JsonArena, AllocatesOnTheHeapWhenTheBufferIsFull)
+{
+    JsonArena arena(256);
+
+    void *block = arena.allocate(512);
+    ASSERT_NE(nullptr, block);
+    memset(block, 0xab, 512);
+
+    EXPECT_EQ(0u, arena.getAllocations());
+    EXPECT_EQ(1u, arena.getHeapAllocations());
+
+    // heap blocks are grown with realloc and given back with free
+    uint8_t *grown = (uint8_t *)arena.reallocate(block, 4096);
+    ASSERT_NE(nullptr, grown);
+    EXPECT_EQ(0xab, grown[511]);
+    EXPECT_EQ(1u, arena.getHeapAllocations());
+    arena.deallocate(grown);
+}
+
+TEST(JsonArena, ReallocateWithoutABlockAllocates)
+{
+    JsonArena arena(256);
+
+    EXPECT_NE(nullptr, arena.reallocate(nullptr, 16));
+    EXPECT_EQ(1u, arena.getAllocations());
+}
+
+TEST(JsonArena, GrowsAndShrinksTheNewestBlockInPlace)
+{
+    JsonArena arena(1024);
+
+    void *block = arena.allocate(32);
+    EXPECT_EQ(block, arena.reallocate(block, 256));
+    EXPECT_EQ(block, arena.reallocate(block, 8));
+
+    // the shrunk block gave its memory back
+    void *next = arena.allocate(8);
+    EXPECT_LT((uint8_t *)next, (uint8_t *)block + 256);
+    EXPECT_EQ(2u, arena.getAllocations());
+}
+
+TEST(JsonArena, MovesAnOlderBlockThatGrows)
+{
+    JsonArena arena(1024);
+
+    char *older = (char *)arena.allocate(16);
+    strcpy(older, "cmd_name");
+    arena.allocate(16);
+
+    char *moved = (char *)arena.reallocate(older, 64);
+    ASSERT_NE(nullptr, moved);
+    EXPECT_NE(older, moved);
+    EXPECT_STREQ("cmd_name", moved);
+    EXPECT_EQ(3u, arena.getAllocations());
+
+    // shrinking an older block keeps it where it is
+    arena.allocate(16);
+    EXPECT_EQ(moved, arena.reallocate(moved, 8));
+}
+
+TEST(JsonArena, MovesTheNewestBlockToTheHeapWhenItOutgrowsTheBuffer)
+{
+    JsonArena arena(256);
+
+    char *block = (char *)arena.allocate(32);
+    strcpy(block, "cmd_name");
+
+    char *moved = (char *)arena.reallocate(block, 1024);
+    ASSERT_NE(nullptr, moved);
+    EXPECT_STREQ("cmd_name", moved);
+    EXPECT_EQ(1u, arena.getHeapAllocations());
+    arena.deallocate(moved);
+}
+
+TEST(JsonArena, FreesOnlyTheNewestBlockInPlace)
+{
+    JsonArena arena(1024);
+
+    void *older = arena.allocate(16);
+    void *newest = arena.allocate(16);
+
+    arena.deallocate(newest);
+    EXPECT_EQ(newest, arena.allocate(16));
+
+    arena.deallocate(older);
+    EXPECT_NE(older, arena.allocate(16));
+}
+
+TEST(JsonArena, ResetReleasesAllBlocks)
+{
+    JsonArena arena(1024);
+
+    void *first = arena.allocate(100);
+    arena.allocate(200);
+    arena.allocate(300);
+    size_t highWater = arena.getHighWater();
+
+    arena.reset();
+
+    EXPECT_EQ(first, arena.allocate(100));
+    EXPECT_EQ(highWater, arena.getHighWater());
+    EXPECT_EQ(0u, arena.getHeapAllocations());
+}
+
+//with the ArduinoJson library of the native environment; a small command is parsed from the buffer alone
+TEST(JsonArena, HoldsAParsedDocument)
+{
+    JsonArena arena(1024);
+    JsonDocument document(&arena);
+
+    for (int i = 0; i < 100; i++)
+    {
+        document.clear();
+        arena.reset();
+        ASSERT_FALSE(deserializeJson(document, "{\"cmd_name\":\"identify\",\"value\":42}"));
+    }
+
+    EXPECT_GT(arena.getAllocations(), 0u);
+    EXPECT_EQ(0u, arena.getHeapAllocations());
+    EXPECT_LE(arena.getHighWater(), 1024u);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
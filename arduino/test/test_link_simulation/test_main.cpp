@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <Arduino.h>
+
+#include "LinkSimulation.h"
+#include "LossyLink.h"
+#include "Config.h"
+
+static LossyLinkImpairments withoutImpairments()
+{
+    LossyLinkImpairments impairments;
+    impairments.loss = 0;
+    impairments.duplicate = 0;
+    impairments.reorder = 0;
+    impairments.corrupt = 0;
+    impairments.latency = 5;
+    impairments.jitter = 0;
+
+    return impairments;
+}
+
+static LossyLinkImpairments withLoss(float loss)
+{
+    LossyLinkImpairments impairments;
+    impairments.loss = loss;
+
+    return impairments;
+}
+
+TEST(LinkSimulation, DeliversEveryPacketOnceWithoutImpairments)
+{
+    LinkSimulation simulation(NET::LOSSY_LINK_SEED, withoutImpairments());
+    LinkSimulationResult result = simulation.run(500, 64, 60000);
+
+    EXPECT_EQ(500u, result.sentPackets);
+    EXPECT_EQ(500u, result.deliveredPackets);
+    EXPECT_EQ(0u, result.missingPackets);
+    EXPECT_EQ(0u, result.retransmittedPackets);
+    EXPECT_EQ(0u, result.duplicatePackets);
+    EXPECT_EQ(0u, result.reorderBufferHighWater);
+    EXPECT_TRUE(result.inOrder);
+    EXPECT_LT(result.duration, 60000ul);
+}
+
+TEST(LinkSimulation, DeliversEveryPacketInOrderOnALossyLink)
+{
+    LinkSimulation simulation(NET::LOSSY_LINK_SEED, withLoss(0.1f));
+    LinkSimulationResult result = simulation.run(500, 64, 600000);
+
+    EXPECT_TRUE(result.inOrder);
+    EXPECT_EQ(0u, result.duplicatePackets);
+    EXPECT_GT(result.retransmittedPackets, 0u);
+    EXPECT_GT(result.link.droppedPackets, 0u);
+    EXPECT_GT(result.link.duplicatedPackets, 0u);
+    EXPECT_GT(result.link.reorderedPackets, 0u);
+    EXPECT_GT(result.link.corruptedPackets, 0u);
+    EXPECT_EQ(500u, result.sentPackets);
+    // every gap is retransmitted before the reorder buffer gives it up, so nothing is lost
+    EXPECT_EQ(500u, result.deliveredPackets);
+    EXPECT_EQ(0u, result.missingPackets);
+    EXPECT_LT(result.duration, 600000ul);
+}
+
+TEST(LinkSimulation, SameSeedGivesTheSameRun)
+{
+    LinkSimulation first(7, withLoss(0.1f));
+    LinkSimulation second(7, withLoss(0.1f));
+    LinkSimulationResult a = first.run(300, 64, 600000);
+    LinkSimulationResult b = second.run(300, 64, 600000);
+
+    EXPECT_EQ(a.deliveredPackets, b.deliveredPackets);
+    EXPECT_EQ(a.retransmittedPackets, b.retransmittedPackets);
+    EXPECT_EQ(a.duration, b.duration);
+    EXPECT_EQ(a.reorderBufferHighWater, b.reorderBufferHighWater);
+    EXPECT_EQ(a.link.droppedPackets, b.link.droppedPackets);
+    EXPECT_EQ(a.link.corruptedPackets, b.link.corruptedPackets);
+    EXPECT_EQ(a.link.queuedHighWater, b.link.queuedHighWater);
+    EXPECT_EQ(7u, a.link.seed);
+}
+
+TEST(LinkSimulation, OtherSeedGivesOtherImpairments)
+{
+    LinkSimulation first(7, withLoss(0.1f));
+    LinkSimulation second(8, withLoss(0.1f));
+    LinkSimulationResult a = first.run(300, 64, 600000);
+    LinkSimulationResult b = second.run(300, 64, 600000);
+
+    EXPECT_FALSE(a.link.droppedPackets == b.link.droppedPackets && a.duration == b.duration);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
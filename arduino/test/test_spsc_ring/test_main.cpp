@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "SpscRing.h"
+#include "Packet.h"
+#include "PacketPool.h"
+#include "Config.h"
+
+TEST(SpscRing, KeepsTheOrderAndTellsFullFromEmpty)
+{
+    SpscRing<int, 4> ring;
+    int item;
+
+    EXPECT_FALSE(ring.pop(item));
+    EXPECT_EQ(4u, ring.getRoom());
+
+    // several rounds so that head and tail wrap around the slots
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            EXPECT_TRUE(ring.push(round * 4 + i));
+        }
+        int rejected = -1;
+        EXPECT_FALSE(ring.push(std::move(rejected)));
+        EXPECT_EQ(4u, ring.size());
+        EXPECT_EQ(0u, ring.getRoom());
+
+        for (int i = 0; i < 4; i++)
+        {
+            ASSERT_TRUE(ring.pop(item));
+            EXPECT_EQ(round * 4 + i, item);
+        }
+        EXPECT_FALSE(ring.pop(item));
+        EXPECT_EQ(0u, ring.size());
+    }
+}
+
+TEST(SpscRing, ReleasesAPoppedSharedPointer)
+{
+    SpscRing<std::shared_ptr<int>, 2> ring;
+    std::shared_ptr<int> value = std::make_shared<int>(1);
+    std::weak_ptr<int> observer = value;
+
+    ring.push(std::move(value));
+    ring.pop(value);
+    value = nullptr;
+
+    EXPECT_TRUE(observer.expired());
+}
+
+/**
+ * @brief one producer thread and one consumer thread like the sampling and the network task; the consumer checks that every number arrives exactly once and in order. a small ring makes the threads meet at the full and at the empty ring as often as possible. build with -fsanitize=thread to let ThreadSanitizer check the memory ordering, see env:native_tsan.
+ */
+template <size_t Capacity>
+static void stress(uint32_t count)
+{
+    SpscRing<uint32_t, Capacity> ring;
+    uint32_t received = 0;
+    bool inOrder = true;
+
+    std::thread consumer([&] {
+        uint32_t item;
+        while (received < count)
+        {
+            if (!ring.pop(item))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            inOrder = inOrder && item == received;
+            received++;
+        }
+    });
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t item = i;
+        while (!ring.push(std::move(item)))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    consumer.join();
+
+    EXPECT_TRUE(inOrder);
+    EXPECT_EQ(count, received);
+    EXPECT_EQ(0u, ring.size());
+}
+
+TEST(SpscRing, TransfersMillionsOfItemsInOrderThroughASmallRing)
+{
+    stress<2>(2000000);
+}
+
+TEST(SpscRing, TransfersMillionsOfItemsInOrderThroughALargeRing)
+{
+    stress<1024>(4000000);
+}
+
+//the sampling to network pipeline of the dual core build: packets from the pool through a ring of MC::SAMPLE_RING_SIZE, checked and released by the other thread
+TEST(SpscRing, CarriesPoolPacketsBetweenThreads)
+{
+    const uint32_t count = 200000;
+    SpscRing<std::shared_ptr<Packet>, MC::SAMPLE_RING_SIZE> ring;
+    size_t packetsInUse = PacketPool::getInstance()->getStatistics().packetsInUse;
+    uint32_t received = 0;
+    bool intact = true;
+
+    std::thread network([&] {
+        std::shared_ptr<Packet> packet;
+        while (received < count)
+        {
+            if (!ring.pop(packet))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            intact = intact && packet->getExtendedSequence() == received && packet->verifyGoodPacket();
+            packet = nullptr;
+            received++;
+        }
+    });
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+        packet->setMethod(NET::HEADER::METHOD_DATA);
+        packet->setSequence(i);
+        packet->setPayload("{\"identity\":\"ACC1\",\"x\":0.12,\"y\":-9.81,\"z\":0.5}");
+        while (!ring.push(std::move(packet)))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    network.join();
+
+    EXPECT_TRUE(intact);
+    EXPECT_EQ(count, received);
+    EXPECT_EQ(packetsInUse, PacketPool::getInstance()->getStatistics().packetsInUse);
+}
+
+//a saturated recording: the data lane of the output queue is full, and the sampling task only fills the ring as far as the pool has room
+TEST(SpscRing, SamplingWithinThePoolRoomDoesNotUseTheHeap)
+{
+    SpscRing<std::shared_ptr<Packet>, MC::SAMPLE_RING_SIZE> ring;
+    std::vector<std::shared_ptr<Packet>> dataLane;
+    PacketPoolStatistics start = PacketPool::getInstance()->getStatistics();
+
+    for (size_t i = 0; i < NET::OUTPUT_QUEUE_CAPACITY; i++)
+    {
+        dataLane.push_back(PacketPool::getInstance()->acquire());
+        dataLane.back()->setPayload("{\"identity\":\"ACC1\"}");
+    }
+
+    for (int round = 0; round < 3; round++)
+    {
+        size_t capacity = min(ring.getRoom(), PacketPool::getInstance()->getRoom());
+        for (size_t i = 0; i < capacity; i++)
+        {
+            std::shared_ptr<Packet> packet = PacketPool::getInstance()->acquire();
+            packet->setPayload("{\"identity\":\"ACC1\"}");
+            ASSERT_TRUE(ring.push(std::move(packet)));
+        }
+    }
+
+    PacketPoolStatistics end = PacketPool::getInstance()->getStatistics();
+    EXPECT_EQ(0u, PacketPool::getInstance()->getRoom());
+    EXPECT_EQ(NET::PACKET_POOL_SIZE, dataLane.size() + ring.size());
+    EXPECT_EQ(start.packetsExhausted, end.packetsExhausted);
+    EXPECT_EQ(start.payloadsExhausted, end.payloadsExhausted);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}